@@ -5,8 +5,8 @@
 #include "core/inference.hpp"
 #include "core/lock.hpp"
 #include "core/naming.hpp"
+#include "core/pubgrub.hpp"
 #include "core/resolver.hpp"
-#include "core/sat.hpp"
 #include "core/semver.hpp"
 
 #endif // !POAC_CORE_HPP
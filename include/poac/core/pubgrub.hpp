@@ -0,0 +1,648 @@
+#ifndef POAC_CORE_PUBGRUB_HPP
+#define POAC_CORE_PUBGRUB_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <functional>
+#include <optional>
+#include <algorithm>
+#include <utility>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "exception.hpp"
+#include "semver.hpp"
+
+
+// Version solving of PubGrub (https://github.com/dart-lang/pub/blob/master/doc/solver.md)
+//
+// Versions of a package are fetched when a dependency on it is first seen, and dependencies of
+//  a version only when the version is selected, so packages and versions that are never tried cost nothing.
+// Conflicts are learnt as incompatibilities, which are also used to explain why solving failed.
+//
+// A set of versions of a package is a bitset over its versions (the newest first),
+//  and the last bit means that the package is not selected. So every term is a set:
+//  `A >=1.0.0` is { A 1.0.0, A 1.1.0, ... } and `not A >=1.0.0` is { other versions of A, not selected }.
+namespace poac::core::pubgrub {
+    // (name, interval)
+    using Dependencies = std::vector<std::pair<std::string, std::string>>;
+
+    struct Provider {
+        // nullopt if the package does not exist
+        std::function<std::optional<std::vector<std::string>>(const std::string&)> versions;
+        std::function<Dependencies(const std::string&, const std::string&)> dependencies;
+    };
+
+    struct Selected {
+        std::string version;
+        Dependencies dependencies;
+    };
+
+    using Set = boost::dynamic_bitset<>;
+
+    struct Term {
+        std::string name;
+        Set allowed;
+
+        bool positive() const {
+            return !allowed.test(allowed.size() - 1);
+        }
+    };
+    Term operator!(const Term& t) {
+        return { t.name, ~t.allowed };
+    }
+
+    enum class Cause {
+        root,
+        dependency,
+        no_versions,
+        derived,
+    };
+
+    // The terms can not all be true.
+    struct Incompatibility {
+        std::vector<Term> terms;
+        Cause cause;
+        // Derived from these two
+        std::size_t left = 0;
+        std::size_t right = 0;
+        // Of the dependency
+        std::string interval;
+    };
+
+    enum class Relation {
+        satisfied,
+        almost_satisfied, // All terms but one are satisfied, and the other is inconclusive.
+        contradicted,
+        inconclusive,
+    };
+
+    class Solver {
+    public:
+        explicit Solver(Provider p, std::string root_name, Dependencies root_dependencies)
+            : provider(std::move(p)), root(std::move(root_name))
+        {
+            domains[root] = { "" };
+            dependencies_cache[{ root, "" }] = std::move(root_dependencies);
+        }
+
+        // Throws exception::error with the explanation if no solution exists.
+        std::map<std::string, Selected> solve() {
+            Term required{ root, Set(2) };
+            required.allowed.set(1); // root is not selected
+            index(add({ { required }, Cause::root, 0, 0, {} }));
+
+            for (std::string next = root; !next.empty(); next = choose_package()) {
+                propagate(next);
+            }
+            std::map<std::string, Selected> result;
+            for (const auto& [name, version] : decisions) {
+                if (name != root) {
+                    result[name] = { version, dependencies_cache.at({ name, version }) };
+                }
+            }
+            return result;
+        }
+
+    private:
+        Provider provider;
+        std::string root;
+        std::map<std::string, std::vector<std::string>> domains; // The newest first
+        std::map<std::pair<std::string, std::string>, Dependencies> dependencies_cache;
+        // Incompatibilities of the dependencies of each version, which are added only once
+        //  even if the version is chosen again after backjumping.
+        std::map<std::pair<std::string, std::string>, std::vector<std::size_t>> dependency_incompatibilities;
+
+        std::vector<Incompatibility> incompatibilities;
+        std::map<std::string, std::vector<std::size_t>> by_package;
+
+        struct Assignment {
+            Term term;
+            std::size_t level;
+            std::optional<std::size_t> cause; // nullopt: a decision
+        };
+        // The partial solution
+        std::vector<Assignment> assignments;
+        std::map<std::string, Set> accumulated; // Intersection of the terms of each package
+        std::map<std::string, std::string> decisions;
+        std::size_t level = 0;
+
+        const std::vector<std::string>& versions(const std::string& name) {
+            if (const auto itr = domains.find(name); itr != domains.end()) {
+                return itr->second;
+            }
+            auto found = provider.versions(name).value_or(std::vector<std::string>{});
+            std::sort(found.begin(), found.end(), [](const auto& l, const auto& r) {
+                return semver::Version(l) > r;
+            });
+            found.erase(std::unique(found.begin(), found.end()), found.end());
+            return domains[name] = std::move(found);
+        }
+
+        // `latest` is the newest version.
+        Set matching(const std::string& name, const std::string& interval) {
+            const auto& vs = versions(name);
+            Set s(vs.size() + 1);
+            if (interval == "latest") {
+                if (!vs.empty()) {
+                    s.set(0);
+                }
+                return s;
+            }
+            semver::Interval i(name, interval);
+            for (std::size_t v = 0; v < vs.size(); ++v) {
+                s[v] = i.satisfies(vs[v]);
+            }
+            return s;
+        }
+
+        Set current(const std::string& name) {
+            if (const auto itr = accumulated.find(name); itr != accumulated.end()) {
+                return itr->second;
+            }
+            return Set(versions(name).size() + 1).set();
+        }
+
+        Relation relation(const Term& t) {
+            const Set a = current(t.name);
+            if (a.is_subset_of(t.allowed)) {
+                return Relation::satisfied;
+            }
+            if (!a.intersects(t.allowed)) {
+                return Relation::contradicted;
+            }
+            return Relation::inconclusive;
+        }
+
+        // The relation, and the term which is not satisfied if almost satisfied
+        std::pair<Relation, std::optional<Term>> relation(const Incompatibility& inc) {
+            std::optional<Term> unsatisfied;
+            for (const auto& t : inc.terms) {
+                switch (relation(t)) {
+                    case Relation::contradicted:
+                        return { Relation::contradicted, std::nullopt };
+                    case Relation::inconclusive:
+                        if (unsatisfied) {
+                            return { Relation::inconclusive, std::nullopt };
+                        }
+                        unsatisfied = t;
+                        break;
+                    default:
+                        break;
+                }
+            }
+            if (!unsatisfied) {
+                return { Relation::satisfied, std::nullopt };
+            }
+            return { Relation::almost_satisfied, unsatisfied };
+        }
+
+        std::size_t add(Incompatibility inc) {
+            incompatibilities.push_back(std::move(inc));
+            return incompatibilities.size() - 1;
+        }
+        // Makes it visible to unit propagation.
+        std::size_t index(const std::size_t id) {
+            for (const auto& t : incompatibilities[id].terms) {
+                by_package[t.name].push_back(id);
+            }
+            return id;
+        }
+
+        void assign(const Term& t, const std::optional<std::size_t> cause) {
+            auto& a = accumulated.try_emplace(t.name, current(t.name)).first->second;
+            a &= t.allowed;
+            assignments.push_back({ t, level, cause });
+        }
+        void decide(const std::string& name, const std::size_t version) {
+            ++level;
+            Term t{ name, Set(versions(name).size() + 1) };
+            t.allowed.set(version);
+            assign(t, std::nullopt);
+            decisions[name] = versions(name)[version];
+        }
+        void backtrack(const std::size_t to) {
+            while (!assignments.empty() && assignments.back().level > to) {
+                if (!assignments.back().cause) {
+                    decisions.erase(assignments.back().term.name);
+                }
+                assignments.pop_back();
+            }
+            accumulated.clear();
+            for (const auto& a : assignments) {
+                auto& s = accumulated.try_emplace(a.term.name, current(a.term.name)).first->second;
+                s &= a.term.allowed;
+            }
+            level = to;
+        }
+
+        void propagate(const std::string& package) {
+            std::vector<std::string> changed{ package };
+            while (!changed.empty()) {
+                const std::string name = changed.back();
+                changed.pop_back();
+                const auto ids = by_package[name]; // It grows while iterating.
+                for (auto itr = ids.rbegin(); itr != ids.rend(); ++itr) {
+                    auto [r, unsatisfied] = relation(incompatibilities[*itr]);
+                    if (r == Relation::satisfied) {
+                        const std::size_t cause = resolve_conflict(*itr);
+                        unsatisfied = relation(incompatibilities[cause]).second;
+                        assign(!*unsatisfied, cause);
+                        changed.assign({ unsatisfied->name });
+                        break;
+                    }
+                    if (r == Relation::almost_satisfied) {
+                        assign(!*unsatisfied, *itr);
+                        if (std::find(changed.begin(), changed.end(), unsatisfied->name) == changed.end()) {
+                            changed.push_back(unsatisfied->name);
+                        }
+                    }
+                }
+            }
+        }
+
+        bool is_failure(const Incompatibility& inc) const {
+            return inc.terms.empty()
+                || (inc.terms.size() == 1 && inc.terms[0].name == root && inc.terms[0].positive());
+        }
+
+        // The terms of the same package are merged, and terms which are always true are dropped.
+        static void add_term(std::vector<Term>& terms, const Term& t) {
+            const auto itr = std::find_if(terms.begin(), terms.end(), [&](const auto& x) { return x.name == t.name; });
+            if (itr == terms.end()) {
+                terms.push_back(t);
+            }
+            else {
+                itr->allowed &= t.allowed;
+            }
+        }
+
+        // The first assignment after which all terms are satisfied
+        // (A term of all versions is satisfied without assignments.)
+        std::size_t find_satisfier(const Incompatibility& inc) const {
+            std::map<std::string, Set> partial;
+            for (std::size_t i = 0; i < assignments.size(); ++i) {
+                const auto& t = assignments[i].term;
+                if (std::none_of(inc.terms.begin(), inc.terms.end(), [&](const auto& x) { return x.name == t.name; })) {
+                    continue;
+                }
+                auto [itr, inserted] = partial.try_emplace(t.name, t.allowed);
+                if (!inserted) {
+                    itr->second &= t.allowed;
+                }
+                if (std::all_of(inc.terms.begin(), inc.terms.end(), [&](const auto& x) {
+                    const auto p = partial.find(x.name);
+                    return p != partial.end() ? p->second.is_subset_of(x.allowed) : x.allowed.all();
+                })) {
+                    return i;
+                }
+            }
+            throw exception::error("Unexcepted error"); // It is satisfied by the partial solution.
+        }
+
+        // The level to backtrack to: the latest level of the satisfiers of the other terms,
+        //  and of the assignments of the same package that, with the satisfier, satisfy its term
+        std::size_t previous_level(const Incompatibility& inc, const std::size_t satisfier) const {
+            const auto& s = assignments[satisfier];
+            std::size_t previous = 0;
+            for (const auto& t : inc.terms) {
+                std::optional<Set> partial;
+                if (t.name == s.term.name) {
+                    partial = s.term.allowed;
+                    if (partial->is_subset_of(t.allowed)) {
+                        continue;
+                    }
+                }
+                for (std::size_t i = 0; i < satisfier; ++i) {
+                    if (assignments[i].term.name != t.name) {
+                        continue;
+                    }
+                    partial = partial ? (*partial & assignments[i].term.allowed) : assignments[i].term.allowed;
+                    if (partial->is_subset_of(t.allowed)) {
+                        previous = std::max(previous, assignments[i].level);
+                        break;
+                    }
+                }
+            }
+            return previous;
+        }
+
+        // Returns the incompatibility which is almost satisfied after backtracking.
+        std::size_t resolve_conflict(std::size_t id) {
+            bool derived = false;
+            for (;;) {
+                if (is_failure(incompatibilities[id])) {
+                    throw exception::error(explain(id));
+                }
+                const std::size_t satisfier = find_satisfier(incompatibilities[id]);
+                const auto& s = assignments[satisfier];
+                const std::size_t previous = previous_level(incompatibilities[id], satisfier);
+                if (!s.cause || previous != s.level) {
+                    if (derived) {
+                        index(id);
+                    }
+                    backtrack(previous);
+                    return id;
+                }
+
+                const auto& inc = incompatibilities[id];
+                const auto& cause = incompatibilities[*s.cause];
+                const auto term = std::find_if(inc.terms.begin(), inc.terms.end(),
+                        [&](const auto& x) { return x.name == s.term.name; });
+                Incompatibility prior{ {}, Cause::derived, id, *s.cause, {} };
+                for (const auto& terms : { std::cref(inc.terms), std::cref(cause.terms) }) {
+                    for (const auto& t : terms.get()) {
+                        if (t.name != s.term.name) {
+                            add_term(prior.terms, t);
+                        }
+                    }
+                }
+                // not (satisfier \ term)
+                if (!s.term.allowed.is_subset_of(term->allowed)) {
+                    add_term(prior.terms, { s.term.name, ~(s.term.allowed - term->allowed) });
+                }
+                prior.terms.erase(std::remove_if(prior.terms.begin(), prior.terms.end(),
+                        [](const auto& t) { return t.allowed.all(); }), prior.terms.end());
+                id = add(std::move(prior));
+                derived = true;
+            }
+        }
+
+        // A package which must be selected but is not decided yet, with the fewest versions left.
+        // The newest one of them is selected, unless its dependencies conflict with the partial solution.
+        // Returns an empty name when all packages are decided.
+        std::string choose_package() {
+            std::optional<std::string> next;
+            std::size_t fewest = 0;
+            for (const auto& [name, a] : accumulated) {
+                if (!a.test(a.size() - 1) && decisions.count(name) == 0 && (!next || a.count() < fewest)) {
+                    next = name;
+                    fewest = a.count();
+                }
+            }
+            if (!next) {
+                return {};
+            }
+            const std::string name = *next;
+            const Set allowed = accumulated.at(name);
+            const auto version = allowed.find_first();
+            if (version == Set::npos) {
+                index(add({ { { name, allowed } }, Cause::no_versions, 0, 0, {} }));
+                return name;
+            }
+
+            const auto& v = versions(name)[version];
+            auto [itr, inserted] = dependency_incompatibilities.try_emplace({ name, v });
+            if (inserted) {
+                auto [deps, uncached] = dependencies_cache.try_emplace({ name, v });
+                if (uncached) {
+                    deps->second = provider.dependencies(name, v);
+                }
+                Term selected{ name, Set(allowed.size()) };
+                selected.allowed.set(version);
+                for (const auto& [dep_name, interval] : deps->second) {
+                    if (dep_name == name) {
+                        continue;
+                    }
+                    const Term dep{ dep_name, ~matching(dep_name, interval) };
+                    itr->second.push_back(index(add({ { selected, dep }, Cause::dependency, 0, 0, interval })));
+                }
+            }
+            bool conflicting = false;
+            for (const std::size_t id : itr->second) {
+                // { selected, not dependency }
+                const Term& dep = incompatibilities[id].terms[1];
+                conflicting = conflicting || relation(dep) == Relation::satisfied;
+            }
+            if (!conflicting) {
+                decide(name, version);
+            }
+            return name;
+        }
+
+        std::string describe(const std::string& name, const Set& allowed) const {
+            if (name == root) {
+                return name;
+            }
+            const auto& vs = domains.at(name);
+            std::vector<std::size_t> selected;
+            for (std::size_t v = 0; v < vs.size(); ++v) {
+                if (allowed.test(v)) {
+                    selected.push_back(v);
+                }
+            }
+            if (selected.size() == vs.size()) {
+                return name;
+            }
+            if (selected.size() == 1) {
+                return name + " " + vs[selected[0]];
+            }
+            if (selected.back() - selected.front() + 1 == selected.size()) {
+                const auto& newest = vs[selected.front()];
+                const auto& oldest = vs[selected.back()];
+                if (selected.front() == 0) {
+                    return name + " >=" + oldest;
+                }
+                if (selected.back() + 1 == vs.size()) {
+                    return name + " <=" + newest;
+                }
+                return name + " >=" + oldest + " and <=" + newest;
+            }
+            std::string s = name + " ";
+            for (const auto v : selected) {
+                s += vs[v] + (v == selected.back() ? "" : " or ");
+            }
+            return s;
+        }
+        std::string describe(const Term& t) const {
+            if (t.positive()) {
+                return describe(t.name, t.allowed);
+            }
+            return "not " + describe(t.name, ~t.allowed);
+        }
+
+        std::string to_string(const Incompatibility& inc) const {
+            switch (inc.cause) {
+                case Cause::root:
+                    return root + " is required";
+                case Cause::dependency: {
+                    std::string s = describe(inc.terms[0]) + " depends on " + inc.terms[1].name + " " + inc.interval;
+                    if (inc.terms[1].allowed.all()) {
+                        s += " which doesn't match any versions";
+                    }
+                    return s;
+                }
+                case Cause::no_versions:
+                    return "no versions of " + inc.terms[0].name + " are left";
+                default:
+                    break;
+            }
+            std::vector<Term> terms;
+            for (const auto& t : inc.terms) {
+                if (!(t.name == root && t.positive())) {
+                    terms.push_back(t);
+                }
+            }
+            if (terms.empty()) {
+                return "version solving failed";
+            }
+            if (terms.size() == 1) {
+                return terms[0].positive() ? describe(terms[0]) + " is forbidden" : describe(!terms[0]) + " is required";
+            }
+            if (terms.size() == 2 && terms[0].positive() != terms[1].positive()) {
+                const auto& p = terms[0].positive() ? terms[0] : terms[1];
+                const auto& n = terms[0].positive() ? terms[1] : terms[0];
+                return describe(p) + " requires " + describe(!n);
+            }
+            if (terms.size() == 2 && terms[0].positive()) {
+                return describe(terms[0]) + " is incompatible with " + describe(terms[1]);
+            }
+            std::string s;
+            for (const auto& t : terms) {
+                s += (s.empty() ? "" : t.name == terms.back().name ? " and " : ", ") + describe(t);
+            }
+            return s + " are incompatible";
+        }
+
+        // The derivation graph of the failure is written from its leaves to the conclusion.
+        // Incompatibilities referred to more than once are numbered, and written only once.
+        class Explanation {
+        public:
+            Explanation(const Solver& s, const std::size_t failure) : solver(s) {
+                count(failure);
+                visit(failure, false);
+            }
+
+            std::string str() const {
+                std::size_t width = 0;
+                for (const auto& [text, number] : lines) {
+                    if (number) {
+                        width = std::max(width, std::to_string(*number).size() + 3);
+                    }
+                }
+                std::string s;
+                for (const auto& [text, number] : lines) {
+                    const std::string prefix = number ? "(" + std::to_string(*number) + ") " : "";
+                    s += (s.empty() ? "" : "\n") + prefix + std::string(width - prefix.size(), ' ') + text;
+                }
+                return s;
+            }
+
+        private:
+            const Solver& solver;
+            std::map<std::size_t, std::size_t> derivations;
+            std::map<std::size_t, std::size_t> numbers;
+            std::vector<std::pair<std::string, std::optional<std::size_t>>> lines;
+
+            const Incompatibility& at(const std::size_t id) const {
+                return solver.incompatibilities[id];
+            }
+            bool is_derived(const std::size_t id) const {
+                return at(id).cause == Cause::derived;
+            }
+            std::string str(const std::size_t id) const {
+                return solver.to_string(at(id));
+            }
+            std::string numbered(const std::size_t id) const {
+                return str(id) + " (" + std::to_string(numbers.at(id)) + ")";
+            }
+
+            void count(const std::size_t id) {
+                if (!is_derived(id)) {
+                    return;
+                }
+                for (const auto cause : { at(id).left, at(id).right }) {
+                    if (derivations[cause]++ == 0) {
+                        count(cause);
+                    }
+                }
+            }
+
+            void write(const std::size_t id, const std::string& text, const bool conclusion) {
+                if (conclusion || derivations[id] > 1) {
+                    numbers[id] = numbers.size() + 1;
+                    lines.emplace_back(text, numbers[id]);
+                }
+                else {
+                    lines.emplace_back(text, std::nullopt);
+                }
+            }
+
+            void visit(const std::size_t id, const bool conclusion) {
+                const auto left = at(id).left;
+                const auto right = at(id).right;
+                const std::string concluded = ", " + str(id) + ".";
+
+                if (is_derived(left) && is_derived(right)) {
+                    const bool l = numbers.count(left) != 0;
+                    const bool r = numbers.count(right) != 0;
+                    if (l && r) {
+                        write(id, "Because " + numbered(left) + " and " + numbered(right) + concluded, conclusion);
+                    }
+                    else if (l || r) {
+                        const auto with = l ? left : right;
+                        visit(l ? right : left, false);
+                        write(id, "And because " + numbered(with) + concluded, conclusion);
+                    }
+                    else {
+                        const auto single_line = [&](const std::size_t c) {
+                            return !is_derived(at(c).left) && !is_derived(at(c).right);
+                        };
+                        if (single_line(left) || single_line(right)) {
+                            const auto first = single_line(left) ? right : left;
+                            visit(first, false);
+                            visit(first == left ? right : left, false);
+                            write(id, "Thus" + concluded, conclusion);
+                        }
+                        else {
+                            visit(left, true);
+                            visit(right, false);
+                            write(id, "And because " + numbered(left) + concluded, conclusion);
+                        }
+                    }
+                }
+                else if (is_derived(left) || is_derived(right)) {
+                    const auto derived = is_derived(left) ? left : right;
+                    const auto external = is_derived(left) ? right : left;
+                    if (numbers.count(derived) != 0) {
+                        write(id, "Because " + str(external) + " and " + numbered(derived) + concluded, conclusion);
+                    }
+                    else if (derivations[derived] == 1
+                             && is_derived(at(derived).left) != is_derived(at(derived).right))
+                    {
+                        // Collapsed into one line with the external cause of the derived one
+                        const auto prior_derived = is_derived(at(derived).left) ? at(derived).left : at(derived).right;
+                        const auto prior_external = is_derived(at(derived).left) ? at(derived).right : at(derived).left;
+                        visit(prior_derived, false);
+                        write(id, "And because " + str(prior_external) + " and " + str(external) + concluded, conclusion);
+                    }
+                    else {
+                        visit(derived, false);
+                        write(id, "And because " + str(external) + concluded, conclusion);
+                    }
+                }
+                else if (at(left).cause == Cause::root || at(right).cause == Cause::root) {
+                    write(id, "Because " + str(at(left).cause == Cause::root ? right : left) + concluded, conclusion);
+                }
+                else {
+                    write(id, "Because " + str(left) + " and " + str(right) + concluded, conclusion);
+                }
+            }
+        };
+
+        std::string explain(const std::size_t failure) const {
+            if (incompatibilities[failure].cause != Cause::derived) {
+                return "Because " + to_string(incompatibilities[failure]) + ", version solving failed.";
+            }
+            return Explanation(*this, failure).str();
+        }
+    };
+
+    std::map<std::string, Selected>
+    solve(Provider provider, const std::string& root, const Dependencies& dependencies) {
+        return Solver(std::move(provider), root, dependencies).solve();
+    }
+} // end namespace
+#endif // !POAC_CORE_PUBGRUB_HPP
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <optional>
 
 #include <boost/filesystem.hpp>
@@ -39,6 +40,12 @@ namespace poac::io::file::path {
     const boost::filesystem::path poac_cache_dir(
             poac_state_dir / "cache"
     );
+    const boost::filesystem::path poac_object_cache_dir(
+            poac_state_dir / "objects"
+    );
+    const boost::filesystem::path poac_toolchain_dir(
+            poac_state_dir / "toolchains"
+    );
     const boost::filesystem::path poac_log_dir(
             poac_state_dir / "logs"
     );
@@ -57,8 +64,24 @@ namespace poac::io::file::path {
     const boost::filesystem::path current_build_cache_obj_dir(
             current_build_cache_dir / "obj"
     );
-    const boost::filesystem::path current_build_cache_hash_dir(
-            current_build_cache_dir / "_hash"
+    const boost::filesystem::path current_build_cache_pch_dir(
+            current_build_cache_dir / "pch"
+    );
+    const boost::filesystem::path current_build_cache_unity_dir(
+            current_build_cache_dir / "unity"
+    );
+    const boost::filesystem::path current_build_cache_state(
+            current_build_cache_dir / "build_state"
+    );
+    // Position independent objects of shared libraries, with their own build state
+    const boost::filesystem::path current_build_cache_pic_dir(
+            current_build_cache_dir / "pic"
+    );
+    const boost::filesystem::path current_build_compile_commands(
+            current_build_dir / "compile_commands.json"
+    );
+    const boost::filesystem::path current_build_trace(
+            current_build_dir / "trace.json"
     );
     const boost::filesystem::path current_build_bin_dir(
             current_build_dir / "bin"
@@ -75,6 +98,15 @@ namespace poac::io::file::path {
     const boost::filesystem::path current_build_test_report_dir(
             current_build_test_dir / "report"
     );
+    // Everything placed directly in current_build_dir, which the trees of profiles must not overlap
+    const std::vector<boost::filesystem::path> current_build_children{
+            current_build_cache_dir,
+            current_build_compile_commands,
+            current_build_trace,
+            current_build_bin_dir,
+            current_build_lib_dir,
+            current_build_test_dir,
+    };
 
     bool validate_dir(const boost::filesystem::path& path) {
         namespace fs = boost::filesystem;
@@ -150,9 +182,11 @@ namespace poac::io::file::path {
         return ret;
     }
 
+    // Like `mktemp -d`
     boost::filesystem::path create_temp() {
-        const std::string temp = *(util::command("mktemp -d").exec());
-        const std::string temp_path(temp, 0, temp.size()-1); // delete \n
+        namespace fs = boost::filesystem;
+        const fs::path temp_path = fs::temp_directory_path() / fs::unique_path("tmp.%%%%%%%%%%");
+        fs::create_directories(temp_path);
         return temp_path;
     }
 
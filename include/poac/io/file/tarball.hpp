@@ -7,19 +7,27 @@
 
 #include <boost/filesystem.hpp>
 
+#include "../../util/process.hpp"
+
 
 namespace poac::io::file::tarball {
     namespace fs = boost::filesystem;
 
-    bool extract(const fs::path& filename, const std::string& options = "") {
-        const std::string cmd = "tar -zxf " + filename.string() + " " + options;
-        return static_cast<bool>(std::system(cmd.data()));
+    // Like std::system, returns true if tar fails.
+    bool extract(const fs::path& filename, const std::vector<std::string>& options = {}) {
+        std::vector<std::string> argv{ "tar", "-zxf", filename.string() };
+        argv.insert(argv.end(), options.begin(), options.end());
+        return !util::process::run(argv).success();
     }
     // ~/.poac/cache/package.tar.gz -> ~/.poac/cache/username-repository-tag/...
-    bool extract_spec(const fs::path& input, const fs::path& output) {
+    // The arguments of extract_spec, to run it with util::process::run_all.
+    std::vector<std::string> extract_spec_args(const fs::path& input, const fs::path& output) {
         boost::system::error_code error;
         fs::create_directories(output, error);
-        return extract(input, "-C " + output.string() + " --strip-components 1");
+        return { "tar", "-zxf", input.string(), "-C", output.string(), "--strip-components", "1" };
+    }
+    bool extract_spec(const fs::path& input, const fs::path& output) {
+        return !util::process::run(extract_spec_args(input, output)).success();
     }
     // It is almost the same behavior as --remove-files,
     //  but deleted in fs::remove because there is a possibility
@@ -30,14 +38,13 @@ namespace poac::io::file::tarball {
     }
 
     bool compress_spec_exclude(const fs::path& input, const fs::path& output, const std::vector<std::string> opts) {
-        std::string exclude;
+        std::vector<std::string> argv{ "tar", "-zcf", fs::absolute(output).string() };
         for (const auto& v : opts) {
-            exclude += "--exclude " + v + " ";
+            argv.push_back("--exclude");
+            argv.push_back(v);
         }
-        const std::string filepath = fs::relative(input.parent_path()).string();
-        const std::string filename = input.filename().string();
-        const std::string cmd = "cd " + filepath + " && " + "tar -zcf " + output.string() + " " + exclude + filename;
-        return static_cast<bool>(std::system(cmd.data()));
+        argv.push_back(input.filename().string());
+        return !util::process::run(argv, { fs::absolute(input.parent_path()), false }).success();
     }
 } // end namespace
 #endif // !POAC_IO_FILE_TARBALL_HPP
@@ -2,9 +2,16 @@
 #define POAC_SUBCMD_BUILD_HPP
 
 #include <iostream>
+#include <sstream>
+#include <iomanip>
 #include <string>
 #include <map>
+#include <vector>
 #include <optional>
+#include <algorithm>
+#include <mutex>
+#include <exception>
+#include <cctype>
 #include <cstdlib>
 
 #include <boost/filesystem.hpp>
@@ -12,6 +19,7 @@
 
 #include "../core/exception.hpp"
 #include "../core/lock.hpp"
+#include "../core/resolver.hpp"
 #include "../io/file.hpp"
 #include "../io/cli.hpp"
 #include "../util/stroite.hpp"
@@ -19,7 +27,7 @@
 #include "../util/argparse.hpp"
 
 
-// TODO: --release, --no-cache, --example, --backend cmake
+// TODO: --no-cache, --example, --backend cmake
 // TODO: --check-std(標準では標準ライブラリをチェックしないため，標準ライブラリを書き換えてもリビルドしない)
 namespace poac::subcmd {
     namespace _build {
@@ -27,17 +35,16 @@ namespace poac::subcmd {
         handle_message(const std::string& method, const std::optional<std::string>& output) {
             namespace fs = boost::filesystem;
             if (output) {
-                std::cout << io::cli::to_green(method + ": ")
-                          << "Output to `"
-                          << fs::relative(*output).string()
-                          << "`"
-                          << std::endl;
+                // Dependencies may be built concurrently.
+                stroite::core::scheduler::print(
+                        io::cli::to_green(method + ": ")
+                        + "Output to `"
+                        + fs::relative(*output).string()
+                        + "`\n");
                 return output;
             }
             else { // Static link library generation failed // Dynamic link library generation failed
-                // TODO: 全部削除すると，testのcacheも消えてしまう．// .dylibだけ消せば？？？ __APPLE__で分岐必要
-                boost::system::error_code error;
-                fs::remove_all(io::file::path::current_build_cache_dir, error);
+                // Objects and build states are kept, since a failed output is not recorded as up to date.
                 return std::nullopt;
             }
         }
@@ -49,32 +56,15 @@ namespace poac::subcmd {
             return handle_message("Generated", output);
         }
 
-        auto handle_link(
-                stroite::builder& bs,
-                const std::vector<std::string>& obj_files_path,
-                const bool verbose)
-        {
-            bs.configure_link(obj_files_path, verbose);
-            return handle_compile_message(bs._link());
-        }
-        std::optional<std::string>
-        handle_compile(
-                stroite::builder& bs,
-                const bool verbose)
-        {
-            if (const auto obj_files_path = bs._compile()) {
-                return handle_link(bs, *obj_files_path, verbose);
-            }
-            else { // Compile failure
-                return std::nullopt;
-            }
-        }
         auto handle_generate_static_lib(
                 stroite::builder& bs,
                 const std::vector<std::string>& obj_files_path,
                 const bool verbose)
         {
             bs.configure_static_lib(obj_files_path, verbose);
+            if (bs.is_up_to_date_static_lib()) {
+                return std::optional<std::string>(stroite::core::compiler::to_static_lib_path(bs.static_lib_conf));
+            }
             return handle_generate_message(bs._gen_static_lib());
         }
         auto handle_generate_dynamic_lib(
@@ -83,16 +73,25 @@ namespace poac::subcmd {
                 const bool verbose)
         {
             bs.configure_dynamic_lib(obj_files_path, verbose);
+            if (bs.is_up_to_date_dynamic_lib()) {
+                return std::optional<std::string>(stroite::core::compiler::to_dynamic_lib_path(bs.dynamic_lib_conf));
+            }
             return handle_generate_message(bs._gen_dynamic_lib());
         }
 
-        void handle_generate_lib(
+        // The shared library is linked from position independent objects.
+        // Returns whether both libraries are generated.
+        bool handle_generate_lib(
                 stroite::builder& bs,
                 const std::vector<std::string>& obj_files_path,
+                const std::vector<std::string>& pic_obj_files_path,
                 const bool verbose)
         {
-            handle_generate_static_lib(bs, obj_files_path, verbose);
-            handle_generate_dynamic_lib(bs, obj_files_path, verbose);
+            const bool static_lib = handle_generate_static_lib(bs, obj_files_path, verbose).has_value();
+            bs.pic = true;
+            const bool dynamic_lib = handle_generate_dynamic_lib(bs, pic_obj_files_path, verbose).has_value();
+            bs.pic = false;
+            return static_lib && dynamic_lib;
         }
 
         void handle_exist_message(
@@ -113,172 +112,475 @@ namespace poac::subcmd {
             handle_exist_message(lib_path, ".a", "Static link library");
         }
         void is_exist_dynamic_lib(const std::string& lib_path) {
-#ifdef __APPLE__
-            const std::string extension = ".dylib";
-#else
-            const std::string extension = ".so";
-#endif
-            handle_exist_message(lib_path, extension, "Dynamic link library");
+            handle_exist_message(lib_path, stroite::utils::options::dynamic_lib_extension, "Dynamic link library");
         }
-        std::string is_exist_lib(const std::string& project_name) {
-            namespace path = io::file::path;
-            const auto lib_path = (path::current_build_lib_dir / project_name).string();
+        std::string is_exist_lib(const boost::filesystem::path& lib_dir, const std::string& project_name) {
+            const auto lib_path = (lib_dir / project_name).string();
             is_exist_static_lib(lib_path);
             is_exist_dynamic_lib(lib_path);
             return lib_path;
         }
 
 
+        // Objects of all sources, compiling only those which have changed.
+        std::optional<std::vector<std::string>>
+        compile_objs(stroite::builder& bs, const bool usemain, const bool verbose, const unsigned int jobs)
+        {
+            bs.configure_compile(usemain, verbose, jobs);
+            return bs.compile_conf.source_files.empty()
+                    ? std::optional(bs.obj_files())
+                    : bs._compile();
+        }
+        // Objects for the shared library are compiled into another tree. (see builder::to_cache_dir)
+        std::optional<std::vector<std::string>>
+        compile_pic_objs(stroite::builder& bs, const bool verbose, const unsigned int jobs)
+        {
+            bs.pic = true;
+            const auto obj_files_path = compile_objs(bs, false, verbose, jobs);
+            bs.pic = false;
+            return obj_files_path;
+        }
+
+        // Even if some sources are compiled, the binary is not linked again
+        //  unless objects, libraries or link_args have changed.
         std::optional<std::string>
-        build_bin(stroite::builder& bs, const bool verbose)
+        build_bin(stroite::builder& bs, const bool verbose, const unsigned int jobs)
         {
-            bs.configure_compile(true, verbose);
-            // Since the obj file already exists and has not been changed as a result
-            //  of verification of the hash file, return only the list of existing obj_files
-            //  and do not compile.
-            // There is no necessity of linking that there is no change completely.
-            if (bs.compile_conf.source_files.empty()) { // No need for compile and link
-                const std::string bin_path =
-                        (io::file::path::current_build_bin_dir / bs.project_name).string();
+            const auto obj_files_path = compile_objs(bs, true, verbose, jobs);
+            if (!obj_files_path) { // Compile failure
+                return std::nullopt;
+            }
+            bs.configure_link(*obj_files_path, verbose);
+            if (bs.is_up_to_date_link()) {
+                const std::string bin_path = stroite::core::compiler::to_bin_path(bs.link_conf);
                 handle_exist_message(bin_path, "", "Binary");
                 return bin_path;
             }
-            else {
-                return handle_compile(bs, verbose);
-            }
+            return handle_compile_message(bs._link());
         }
 
         std::optional<std::string>
-        build_link_libs(stroite::builder& bs, const bool verbose)
+        build_link_libs(stroite::builder& bs, const bool verbose, const unsigned int jobs)
         {
-            bs.configure_compile(false, verbose);
-            if (bs.compile_conf.source_files.empty()) { // No need for compile and link
-                return is_exist_lib(bs.project_name);
+            const auto obj_files_path = compile_objs(bs, false, verbose, jobs);
+            if (!obj_files_path) { // Compile failure
+                return std::nullopt;
             }
-            if (const auto obj_files_path = bs._compile()) {
-                handle_generate_lib(bs, *obj_files_path, verbose);
+            const auto pic_obj_files_path = compile_pic_objs(bs, verbose, jobs);
+            if (!pic_obj_files_path) {
                 return std::nullopt;
             }
-            else { // Compile failure
+            bs.configure_static_lib(*obj_files_path, verbose);
+            bs.pic = true;
+            bs.configure_dynamic_lib(*pic_obj_files_path, verbose);
+            const bool dynamic_lib_up_to_date = bs.is_up_to_date_dynamic_lib();
+            bs.pic = false;
+            if (bs.is_up_to_date_static_lib() && dynamic_lib_up_to_date) {
+                return is_exist_lib(bs.static_lib_conf.output_root, bs.project_name);
+            }
+            if (!handle_generate_lib(bs, *obj_files_path, *pic_obj_files_path, verbose)) {
                 return std::nullopt;
             }
+            return ( bs.static_lib_conf.output_root / bs.project_name ).string();
         }
 
 
-        bool compile_deps(
-                const YAML::Node& node,
+        // depsのビルド時はbinaryは不要．必要になる可能性があるのはlibraryのみ
+        // Builders are made serially, since they read configuration files.
+        std::optional<stroite::builder>
+        configure_deps(const YAML::Node& node, const boost::filesystem::path& deps_path) {
+            if (io::file::yaml::get(node, "build", "lib")) {
+                return stroite::builder(deps_path);
+            }
+            return std::nullopt;
+        }
+
+        // Only the static library of a dependency is linked (see builder::make_link),
+        //  so that neither position independent objects nor the shared library are built.
+        void compile_deps(
+                stroite::builder& bs,
                 const std::string& name,
-                const boost::filesystem::path& deps_path,
-                const bool verbose)
+                const bool verbose,
+                const unsigned int jobs)
         {
             namespace exception = core::exception;
 
-            // depsのビルド時はbinaryは不要．必要になる可能性があるのはlibraryのみ
-            if (io::file::yaml::get(node, "build", "lib")) {
-                stroite::builder bs(deps_path);
-
-                bs.configure_compile(false, verbose);
-                if (!bs.compile_conf.source_files.empty()) {
-                    std::cout << io::cli::to_status(name) << std::endl;
+            stroite::core::trace::span span(name, "phase");
+            bs.configure_compile(false, verbose, jobs);
+            std::optional<std::vector<std::string>> obj_files_path = bs.obj_files();
+            if (!bs.compile_conf.source_files.empty()) {
+                stroite::core::scheduler::print(io::cli::to_status(name) + "\n");
+                obj_files_path = bs._compile();
+                if (!obj_files_path) { // Compile failure
+                    throw exception::error("\nCompile error.");
+                }
+            }
+            else {
+                // Generated again if the last generation failed, even though no source has changed.
+                bs.configure_static_lib(*obj_files_path, verbose);
+                if (bs.is_up_to_date_static_lib()) {
+                    return;
+                }
+                stroite::core::scheduler::print(io::cli::to_status(name) + "\n");
+            }
+            if (!handle_generate_static_lib(bs, *obj_files_path, verbose)) {
+                throw exception::error("\nFailed to generate the static link library of " + name + ".");
+            }
+            stroite::core::scheduler::print("\n");
+        }
 
-                    if (const auto obj_files_path = bs._compile()) {
-                        handle_generate_lib(bs, *obj_files_path, verbose);
-                    }
-                    else { // Compile failure
-                        throw exception::error("\nCompile error.");
+        // Edges of the dependency graph written in poac.lock.
+        // dependencies[i] is the packages which names[i] depends on.
+        std::vector<std::vector<std::size_t>>
+        make_dependency_graph(
+                const core::resolver::Resolved& locked_deps,
+                const std::vector<std::string>& names)
+        {
+            std::map<std::string, std::size_t> index;
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                index.emplace(names[i], i);
+            }
+            std::vector<std::vector<std::size_t>> dependencies(names.size());
+            for (const auto& package : locked_deps.activated) {
+                const auto itr = index.find(package.name);
+                // Skip versions which are not selected.
+                if (itr == index.end() || locked_deps.backtracked.at(package.name).version != package.version) {
+                    continue;
+                }
+                auto& edges = dependencies[itr->second];
+                for (const auto& dep : package.deps) {
+                    if (const auto d = index.find(dep.name); d != index.end()
+                        && std::find(edges.begin(), edges.end(), d->second) == edges.end())
+                    {
+                        edges.push_back(d->second);
                     }
-                    std::cout << std::endl;
                 }
-
-                return true;
             }
-            return false;
+            return dependencies;
         }
 
-        void build_deps(const YAML::Node& node, const bool verbose) {
+        // Packages are built in a topological order of the dependency graph,
+        //  and packages which do not depend on each other are built concurrently.
+        // All of them share the jobs with the compilation of each translation unit.
+        void build_deps(
+                const YAML::Node& node,
+                const bool verbose,
+                const unsigned int jobs,
+                const bool unity,
+                const stroite::core::profile::settings& profile)
+        {
             namespace fs = boost::filesystem;
             namespace exception = core::exception;
             namespace lock = core::lock;
             namespace naming = core::naming;
             namespace yaml = io::file::yaml;
+            namespace scheduler = stroite::core::scheduler;
 
 
-            if (!yaml::get(node, "deps")) {
+            if (!yaml::get<std::map<std::string, YAML::Node>>(node, "deps")) {
                 return; // depsが存在しない
             }
-            // TODO: ビルド順序
-            if (const auto locked_deps = lock::load_ignore_timestamp()) {
-                for (const auto& [name, dep] : (*locked_deps).backtracked) {
-                    const std::string current_package_name = naming::to_current(dep.source, name, dep.version);
-                    const auto deps_path = fs::current_path() / "deps" / current_package_name;
-
-                    if (fs::exists(deps_path)) {
-                        // IF dep.source == "github"
-                        // ./deps/pack/poac.yml は存在しないと見做す (TODO: poac projectなのにgithubをsourceとしている場合がある)
-                        // 現状は，./poac.ymlから，buildキーを読み込む -> 無いなら header-onlyと見做す．
-
-                        // IF dep.source == "poac"
-                        // プロジェクトルートの方に，buildキーがあるならそちらを
-                        //  -> 無いなら，提供者->deps_pathの方を選ぶ
-                        //  -> 無いなら，header-onlyと見做す．
-                        if (!compile_deps(node, name, deps_path, verbose) && dep.source == "poac") {
-                            const auto deps_config_node = yaml::load_config_by_dir(deps_path);
-                            compile_deps(deps_config_node, name, deps_path, verbose);
-                        }
+            const auto locked_deps = [] {
+                stroite::core::trace::span span("resolve", "phase");
+                return lock::load_ignore_timestamp();
+            }();
+            if (!locked_deps) {
+                throw exception::error(
+                        "Could not load poac.lock.\n"
+                        "Please build after running `poac install`");
+            }
+
+            std::vector<std::string> names;
+            std::vector<std::optional<stroite::builder>> builders;
+            for (const auto& [name, dep] : (*locked_deps).backtracked) {
+                const std::string current_package_name = naming::to_current(dep.source, name, dep.version);
+                const auto deps_path = fs::current_path() / "deps" / current_package_name;
+
+                if (fs::exists(deps_path)) {
+                    // IF dep.source == "github"
+                    // ./deps/pack/poac.yml は存在しないと見做す (TODO: poac projectなのにgithubをsourceとしている場合がある)
+                    // 現状は，./poac.ymlから，buildキーを読み込む -> 無いなら header-onlyと見做す．
+
+                    // IF dep.source == "poac"
+                    // プロジェクトルートの方に，buildキーがあるならそちらを
+                    //  -> 無いなら，提供者->deps_pathの方を選ぶ
+                    //  -> 無いなら，header-onlyと見做す．
+                    auto bs = configure_deps(node, deps_path);
+                    if (!bs && dep.source == "poac") {
+                        bs = configure_deps(yaml::load_config_by_dir(deps_path), deps_path);
                     }
-                    else {
-                        throw exception::error(
-                                name + " is not installed.\n"
-                                       "Please build after running `poac install`");
+                    if (bs) {
+                        bs->unity = unity;
+                        bs->profile = profile;
                     }
+                    names.push_back(name);
+                    builders.push_back(std::move(bs));
+                }
+                else {
+                    throw exception::error(
+                            name + " is not installed.\n"
+                                   "Please build after running `poac install`");
                 }
             }
-            else {
-                throw exception::error(
-                        "Could not load poac.lock.\n"
-                        "Please build after running `poac install`");
+
+            std::mutex mtx;
+            std::exception_ptr error;
+            std::vector<scheduler::task> tasks;
+            for (std::size_t i = 0; i < names.size(); ++i) {
+                tasks.emplace_back([&, i]() {
+                    if (builders[i]) {
+                        try {
+                            compile_deps(*builders[i], names[i], verbose, jobs);
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> lock(mtx);
+                            if (!error) {
+                                error = std::current_exception();
+                            }
+                            return scheduler::output{ false, "" };
+                        }
+                    }
+                    return scheduler::output{ true, "" };
+                });
+            }
+
+            if (!scheduler::run_graph(tasks, make_dependency_graph(*locked_deps, names), jobs)) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                throw exception::error("Circular dependencies are found in poac.lock.");
             }
         }
 
-        template<typename VS, typename = std::enable_if_t<std::is_rvalue_reference_v<VS&&>>>
-        int _main(VS&& argv) {
+        std::string to_seconds(const double s) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(3) << s << "s";
+            return oss.str();
+        }
+
+        void report_timings() {
+            namespace fs = boost::filesystem;
+            namespace trace = stroite::core::trace;
+
+            const auto stat = stroite::core::memo::fingerprints().statistic();
+            std::cout << io::cli::to_status("Timings") << std::endl
+                      << "Fingerprints: " << stat.lookups << " lookups, "
+                      << stat.hits << " memoized, "
+                      << stat.stats << " stat'ed, "
+                      << stat.hashed << " hashed"
+                      << std::endl;
+
+            const auto summary = trace::summarize();
+            std::cout << "Total: " << to_seconds(summary.wall_time)
+                      << ", Jobs: " << to_seconds(summary.job_time)
+                      << ", Parallelism: " << std::fixed << std::setprecision(2) << summary.parallelism()
+                      << std::defaultfloat << std::endl;
+            if (!summary.slowest.empty()) {
+                std::cout << "Slowest translation units:" << std::endl;
+                for (const auto& e : summary.slowest) {
+                    std::cout << "  " << to_seconds(e.duration()) << "  " << e.name << std::endl;
+                }
+            }
+            if (!summary.critical_path.empty()) {
+                double total = 0.0;
+                for (const auto& e : summary.critical_path) {
+                    total += e.duration();
+                }
+                std::cout << "Critical path (" << to_seconds(total) << "):" << std::endl;
+                for (const auto& e : summary.critical_path) {
+                    std::cout << "  " << to_seconds(e.duration()) << "  " << e.category << " " << e.name << std::endl;
+                }
+            }
+            trace::write_chrome_trace(io::file::path::current_build_trace);
+            std::cout << "Trace: Output to `" << fs::relative(io::file::path::current_build_trace).string() << "`"
+                      << std::endl;
+        }
+
+        // Headers which cost the most over all translation units built in this directory.
+        // This only reads the build state, so it costs nothing extra after a build.
+        void report_includes(const std::string& profile, const std::size_t limit = 20) {
             namespace fs = boost::filesystem;
+            namespace includes = stroite::core::includes;
+
+            const auto costs = includes::analyze(stroite::core::state::open(
+                    stroite::core::profile::to_dir(io::file::path::current_build_cache_state, profile)));
+            std::cout << io::cli::to_status("Include report") << std::endl;
+            if (costs.empty()) {
+                std::cout << "No headers are recorded." << std::endl;
+                return;
+            }
+            std::cout << std::setw(8) << "TUs" << std::setw(12) << "Size"
+                      << std::setw(14) << "Total size" << std::setw(12) << "Est. time"
+                      << "  Header" << std::endl;
+            for (std::size_t i = 0; i < std::min(limit, costs.size()); ++i) {
+                const auto& c = costs[i];
+                std::cout << std::setw(8) << c.fan_in << std::setw(12) << c.size
+                          << std::setw(14) << c.total_size << std::setw(12) << to_seconds(c.estimated_time)
+                          << "  " << fs::relative(c.path).string() << std::endl;
+            }
+        }
+
+        // -j N, --jobs N (default: the number of hardware threads)
+        unsigned int parse_jobs(const std::vector<std::string>& argv) {
             namespace exception = core::exception;
-            namespace naming = core::naming;
+            if (const auto jobs = util::argparse::use_get(argv, "-j", "--jobs")) {
+                if (!jobs->empty() && std::all_of(jobs->begin(), jobs->end(), ::isdigit)) {
+                    try {
+                        if (const int n = std::stoi(*jobs); n > 0) {
+                            return static_cast<unsigned int>(n);
+                        }
+                    }
+                    catch (const std::out_of_range&) {
+                        // Too large for a number of jobs
+                    }
+                }
+                throw exception::error("Invalid number of jobs: `" + *jobs + "`");
+            }
+            return stroite::core::scheduler::default_jobs();
+        }
+
+        // --release is --profile release (default: debug)
+        std::string parse_profile(const std::vector<std::string>& argv) {
+            if (const auto profile = util::argparse::use_get(argv, "--profile")) {
+                return *profile;
+            }
+            if (util::argparse::use(argv, "--release")) {
+                return "release";
+            }
+            return stroite::core::profile::default_name;
+        }
+
+        // Returns the path of the binary if it is built.
+        std::optional<std::string>
+        build_project(
+                const YAML::Node& node,
+                const bool verbose,
+                const unsigned int jobs,
+                const bool unity,
+                const stroite::core::profile::settings& profile)
+        {
+            namespace fs = boost::filesystem;
             namespace yaml = io::file::yaml;
 
-            const auto node = yaml::load_config();
-            const bool verbose = util::argparse::use(argv, "-v", "--verbose");
             const auto project_name = yaml::get_with_throw<std::string>(node, "name");
-
-            build_deps(node, verbose);
+            build_deps(node, verbose, jobs, unity, profile);
             stroite::builder bs;
+            bs.unity = unity;
+            bs.profile = profile;
             std::cout << io::cli::to_status(project_name) << std::endl;
+            stroite::core::trace::span span(project_name, "phase");
             if (yaml::get(node, "build", "lib")) {
-                if (!build_link_libs(bs, verbose)) {
+                if (!build_link_libs(bs, verbose, jobs)) {
                     // compile or gen error
                 }
             }
             if (yaml::get(node, "build", "bin")) { // TODO: もし上でlibをビルドしたのなら，それを利用してバイナリをビルドする
                 // TODO: ディレクトリで指定できるように
-                if (!build_bin(bs, verbose)) {
+                if (const auto bin_path = build_bin(bs, verbose, jobs)) {
+                    return bin_path;
+                }
+                else {
                     // compile or link error
 
                     // 一度コンパイルに成功した後にpoac runを実行し，コンパイルに失敗しても実行されるエラーの回避
-                    const auto binary_name = io::file::path::current_build_bin_dir / project_name;
+                    const auto binary_name = bs.to_profile_dir(io::file::path::current_build_bin_dir) / project_name;
                     const fs::path executable_path = fs::relative(binary_name);
                     boost::system::error_code error;
                     fs::remove(executable_path, error);
                 }
             }
+            return std::nullopt;
+        }
+
+        // --pgo: an instrumented build, a training run with `pgo: args`, and an optimized build.
+        void build_pgo(
+                const YAML::Node& node,
+                const bool verbose,
+                const unsigned int jobs,
+                const bool unity,
+                const stroite::core::profile::settings& profile)
+        {
+            namespace exception = core::exception;
+            namespace yaml = io::file::yaml;
+            namespace pgo = stroite::core::pgo;
+
+            if (!yaml::get(node, "build", "bin")) {
+                throw exception::error("--pgo needs a binary to train (build: bin: true).");
+            }
+            const bool is_clang = stroite::core::toolchain::get(stroite::utils::configure::auto_select_compiler()).is_clang;
+            const auto instrumented = pgo::instrumented(profile, is_clang);
+            pgo::clean(instrumented.name);
+            const auto bin_path = build_project(node, verbose, jobs, unity, instrumented);
+            if (!bin_path) {
+                throw exception::error("Failed to build the instrumented binary.");
+            }
+
+            std::vector<std::string> train{ *bin_path };
+            if (const auto args = yaml::get<std::vector<std::string>>(node, "pgo", "args")) {
+                train.insert(train.end(), args->begin(), args->end());
+            }
+            std::cout << io::cli::to_status("Training") << std::endl;
+            {
+                stroite::core::trace::span span("training", "pgo");
+                pgo::train(train, verbose);
+            }
+            pgo::collect(profile.name, is_clang, verbose);
+
+            build_project(node, verbose, jobs, unity, pgo::optimized(profile, is_clang));
+        }
+
+        template<typename VS, typename = std::enable_if_t<std::is_rvalue_reference_v<VS&&>>>
+        int _main(VS&& argv) {
+            namespace yaml = io::file::yaml;
+
+            const auto node = yaml::load_config();
+            const bool verbose = util::argparse::use(argv, "-v", "--verbose");
+            const unsigned int jobs = parse_jobs(argv);
+            stroite::core::scheduler::set_jobs(jobs);
+            const bool timings = util::argparse::use(argv, "--timings");
+            if (timings) {
+                stroite::core::trace::get().enable();
+            }
+            const bool unity = util::argparse::use(argv, "--unity");
+            const bool include_report = util::argparse::use(argv, "--include-report");
+            const bool pgo = util::argparse::use(argv, "--pgo");
+            auto profile_name = parse_profile(argv);
+            // PGO is for optimized builds, so it is release unless a profile is given explicitly.
+            if (pgo && !util::argparse::use(argv, "--profile")) {
+                profile_name = "release";
+            }
+            const auto profile = stroite::core::profile::resolve(node, profile_name);
+
+            if (pgo) {
+                build_pgo(node, verbose, jobs, unity, profile);
+            }
+            else {
+                build_project(node, verbose, jobs, unity, profile);
+            }
+            if (timings) {
+                report_timings();
+            }
+            if (include_report) {
+                report_includes(profile.name);
+            }
 
             return EXIT_SUCCESS;
         }
 
         void check_arguments(const std::vector<std::string>& argv) {
             namespace exception = core::exception;
-            if (argv.size() > 1) {
-                throw exception::invalid_second_arg("build");
+            for (auto itr = argv.begin(); itr != argv.end(); ++itr) {
+                if (*itr == "-v" || *itr == "--verbose" || *itr == "--timings" || *itr == "--unity"
+                    || *itr == "--include-report" || *itr == "--release" || *itr == "--pgo")
+                {
+                    continue;
+                }
+                else if ((*itr == "-j" || *itr == "--jobs" || *itr == "--profile") && itr + 1 != argv.end()) {
+                    ++itr; // skip the value
+                }
+                else {
+                    throw exception::invalid_second_arg("build");
+                }
             }
         }
     }
@@ -288,7 +590,7 @@ namespace poac::subcmd {
             return "Compile all sources that depend on this project";
         }
         static const std::string options() {
-            return "[-v | --verbose]";
+            return "[-v | --verbose, -j | --jobs <N>, --release, --profile <name>, --pgo, --timings, --unity, --include-report]";
         }
         template<typename VS, typename = std::enable_if_t<std::is_rvalue_reference_v<VS&&>>>
         int operator()(VS&& argv) {
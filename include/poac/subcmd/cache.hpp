@@ -13,6 +13,7 @@
 #include "../io/file.hpp"
 #include "../io/cli.hpp"
 #include "../util/argparse.hpp"
+#include "../util/stroite/core/object_cache.hpp"
 
 
 namespace poac::subcmd {
@@ -60,6 +61,23 @@ namespace poac::subcmd {
             }
         }
 
+        void stats() {
+            namespace object_cache = stroite::core::object_cache;
+            const auto stat = object_cache::load_statistics();
+            const auto usage = object_cache::calc_usage();
+            const auto lookups = stat.hits + stat.misses;
+            std::cout << "Object cache: " << object_cache::root().string() << std::endl
+                      << "Hits:         " << stat.hits;
+            if (lookups != 0) {
+                std::cout << " (" << stat.hits * 100 / lookups << "%)";
+            }
+            std::cout << std::endl
+                      << "Misses:       " << stat.misses << std::endl
+                      << "Objects:      " << usage.objects << std::endl
+                      << "Size:         " << usage.size / 1024 << " KiB / "
+                                            << object_cache::max_size() / 1024 << " KiB" << std::endl;
+        }
+
         void root() {
             std::cout << io::file::path::poac_cache_dir.string() << std::endl;
         }
@@ -71,6 +89,9 @@ namespace poac::subcmd {
             if (argv[0] == "root" && argv.size() == 1) {
                 root();
             }
+            else if (argv[0] == "stats" && argv.size() == 1) {
+                stats();
+            }
             else if (argv[0] == "list") {
                 list(std::vector<std::string>(argv.begin() + 1, argv.begin() + argv.size()));
             }
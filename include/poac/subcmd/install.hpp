@@ -89,6 +89,16 @@ namespace poac::subcmd {
             namespace resolver = core::resolver;
             namespace fs = boost::filesystem;
 
+            struct fetched_package {
+                std::string name;
+                const resolver::PackageMini* dep;
+                std::string tar_dir;
+                std::string cache_name;
+                std::string current_name;
+            };
+            std::vector<util::process::job> extractions;
+            std::vector<fetched_package> fetched;
+
             int exists_count = 0;
             for (const auto& [name, dep] : deps) {
                 const auto cache_name = naming::to_cache(dep.source, name, dep.version);
@@ -130,19 +140,27 @@ namespace poac::subcmd {
                     }
 
                     io::network::get(target, tar_dir, POAC_STORAGE_HOST);
-                    // If res is true, does not execute func. (short-circuit evaluation)
-                    bool res = tb::extract_spec_rm(tar_dir, pkg_dir);
-                    res = res || copy_to_current(cache_name, current_name);
-
-                    if (!quite) {
-                        echo_install_status(res, name, dep.version, dep.source);
-                    }
+                    // Archives are extracted together after all downloads.
+                    extractions.push_back({ tb::extract_spec_args(tar_dir, pkg_dir) });
+                    fetched.push_back({ name, &dep, tar_dir, cache_name, current_name });
                 }
                 else {
                     // If called this, it is a bug.
                     throw exception::error("Unexcepted error");
                 }
             }
+
+            util::process::run_all(extractions, stroite::core::scheduler::default_jobs(),
+                [&](const std::size_t i, const util::process::result& result) {
+                    const auto& f = fetched[i];
+                    boost::system::error_code error;
+                    fs::remove(f.tar_dir, error);
+                    // If res is true, does not execute func. (short-circuit evaluation)
+                    const bool res = !result.success() || copy_to_current(f.cache_name, f.current_name);
+                    if (!quite) {
+                        echo_install_status(res, f.name, f.dep->version, f.dep->source);
+                    }
+                });
             if (exists_count == static_cast<int>(deps.size())) {
                 io::cli::echo(io::cli::to_yellow("WARN: "), "Already installed");
             }
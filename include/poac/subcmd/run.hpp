@@ -26,18 +26,21 @@ namespace poac::subcmd {
 
             std::vector<std::string> program_args;
             // poac run -v -- -h build
-            if (const auto result = std::find(argv.begin(), argv.end(), "--"); result != argv.end()) {
+            const auto separator = std::find(argv.begin(), argv.end(), "--");
+            const auto profile = _build::parse_profile(std::vector<std::string>(argv.begin(), separator));
+            if (separator != argv.end()) {
                 // -h build
-                program_args = std::vector<std::string>(result + 1, argv.end());
+                program_args = std::vector<std::string>(separator + 1, argv.end());
                 // -v
-                subcmd::build{}(std::vector<std::string>(argv.begin(), result));
+                subcmd::build{}(std::vector<std::string>(argv.begin(), separator));
             }
             else {
                 subcmd::build{}(std::move(argv));
             }
 
             const std::string project_name = node.at("name").as<std::string>();
-            const fs::path executable_path = fs::relative(io::file::path::current_build_bin_dir / project_name);
+            const auto bin_dir = stroite::core::profile::to_dir(io::file::path::current_build_bin_dir, profile);
+            const fs::path executable_path = fs::relative(bin_dir / project_name);
             if (!fs::exists(executable_path)) {
                 return EXIT_FAILURE;
             }
@@ -67,7 +70,7 @@ namespace poac::subcmd {
             return "Build project and exec it";
         }
         static const std::string options() {
-            return "[-v | --verbose | -- [program args]]";
+            return "[-v | --verbose, --release, --profile <name> | -- [program args]]";
         }
         template <typename VS, typename=std::enable_if_t<std::is_rvalue_reference_v<VS&&>>>
         int operator()(VS&& argv) {
@@ -3,6 +3,9 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <fstream>
+#include <optional>
 #include <cstdlib>
 
 #include <boost/filesystem.hpp>
@@ -13,6 +16,9 @@
 #include "../io/cli.hpp"
 #include "../util/stroite.hpp"
 #include "../util/argparse.hpp"
+#include "../util/process.hpp"
+#include "../util/pretty_time.hpp"
+#include "./build.hpp"
 
 
 // TODO: エラーがあるならちゃんと，EXIT_FAILUREを返す
@@ -25,6 +31,8 @@ namespace poac::subcmd {
 
             const auto node = io::file::yaml::load_config("test");
             const bool verbose = util::argparse::use(argv, "-v", "--verbose");
+            // Arguments after `--` are for the test binaries. (e.g. poac test -j 2 -- -j 4)
+            const unsigned int jobs = _build::parse_jobs({ argv.begin(), std::find(argv.begin(), argv.end(), "--") });
 
             const bool usemain = false;
 
@@ -49,6 +57,8 @@ namespace poac::subcmd {
                 }
             }
 
+            std::vector<util::process::job> tests;
+            std::vector<std::optional<fs::path>> reports;
             for (const fs::path &p : fs::recursive_directory_iterator(fs::current_path() / "test")) {
                 if (!fs::is_directory(p) && p.extension().string() == ".cpp") {
                     const std::string cpp_relative = fs::relative(p).string();
@@ -90,48 +100,57 @@ namespace poac::subcmd {
                     //
                     // execute binary
                     //
-                    util::command cmd(fs::relative(bin_path).string());
+                    std::vector<std::string> cmd{ fs::relative(bin_path).string() };
                     // poac test -v -- -h build
                     if (const auto result = std::find(argv.begin(), argv.end(), "--"); result != argv.end()) {
                         // -h build
-                        std::vector<std::string> test_args(result + 1, argv.end());
-                        for (const auto &s : test_args) {
-                            cmd += s;
-                        }
+                        cmd.insert(cmd.end(), result + 1, argv.end());
                     }
                     else if (const auto test_args = io::file::yaml::get<std::vector<std::string>>(
                             node.at("test"), "args"))
                     {
-                        for (const auto &s : *test_args) {
-                            cmd += s;
-                        }
+                        cmd.insert(cmd.end(), test_args->begin(), test_args->end());
                     }
+                    std::optional<fs::path> report;
                     if (util::argparse::use(argv, "--report")) {
-                        fs::create_directories(io::file::path::current_build_test_report_dir);
-                        cmd += ">";
-                        cmd += (io::file::path::current_build_test_report_dir / bin_name).string() + ".xml";
+                        report = io::file::path::current_build_test_report_dir / (bin_name + ".xml");
                     }
                     else if (const auto test_report = io::file::yaml::get<bool>(node.at("test"), "report")) {
                         if (*test_report) {
-                            fs::create_directories(io::file::path::current_build_test_report_dir);
-                            cmd += ">";
-                            cmd += (io::file::path::current_build_test_report_dir / bin_name).string() + ".xml";
+                            report = io::file::path::current_build_test_report_dir / (bin_name + ".xml");
                         }
                     }
-                    // TODO: echo => Output .xml ...
-
-                    std::cout << io::cli::green << "Running: " << io::cli::reset
-                              << "`" + fs::relative(bin_path).string() + "`"
-                              << std::endl;
-                    if (const auto ret = cmd.exec())
-                        std::cout << *ret;
-                    else
-                        std::cout << std::endl
-                                  << fs::relative(bin_path).string() + " returned 1" << std::endl;
-
-                    std::cout << "----------------------------------------------------------------" << std::endl;
+                    tests.push_back({ cmd, { std::nullopt, !report } });
+                    reports.push_back(report);
                 }
             }
+
+            // Test binaries run in parallel, and the output of each is printed at once when it exits.
+            util::process::run_all(tests, jobs, [&](const std::size_t i, const util::process::result& result) {
+                const std::string& bin = tests[i].argv.front();
+                std::cout << io::cli::green << "Running: " << io::cli::reset
+                          << "`" + bin + "`"
+                          << std::endl;
+                if (reports[i]) {
+                    fs::create_directories(reports[i]->parent_path());
+                    std::ofstream(reports[i]->string()) << result.out;
+                    std::cout << io::cli::green << "Report: " << io::cli::reset
+                              << "Output to `" + fs::relative(*reports[i]).string() + "`"
+                              << std::endl
+                              << result.err;
+                }
+                else {
+                    std::cout << result.out;
+                }
+                if (!result.success()) {
+                    std::cout << std::endl
+                              << bin + " returned " + std::to_string(result.exit_code) << std::endl;
+                }
+                std::cout << "Time: " << util::pretty_time::to(std::to_string(result.usage.wall_time))
+                          << ", Max RSS: " << result.usage.max_rss << " KiB"
+                          << std::endl;
+                std::cout << "----------------------------------------------------------------" << std::endl;
+            });
             return EXIT_SUCCESS;
         }
 
@@ -147,7 +166,7 @@ namespace poac::subcmd {
             return "Execute tests";
         }
         static const std::string options() {
-            return "[-v | --verbose, --report, -- args]";
+            return "[-v | --verbose, --report, -j N | --jobs N, -- args]";
         }
         template <typename VS, typename=std::enable_if_t<std::is_rvalue_reference_v<VS&&>>>
         int operator()(VS&& argv) {
@@ -5,6 +5,7 @@
 #include "util/command.hpp"
 #include "util/ftemplate.hpp"
 #include "util/pretty_time.hpp"
+#include "util/process.hpp"
 #include "util/stroite.hpp"
 #include "util/types.hpp"
 
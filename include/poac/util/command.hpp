@@ -4,8 +4,11 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <array>
 #include <optional>
 
+#include "./process.hpp"
+
 
 namespace poac::util {
     class command {
@@ -111,7 +114,7 @@ namespace poac::util {
 
     namespace _command {
         bool has_command(const std::string &c) {
-            return command("type " + c + " >/dev/null 2>&1").exec() ? true : false;
+            return process::find_executable(c).has_value();
         }
     }
 } // end namespace
@@ -0,0 +1,367 @@
+#ifndef POAC_UTIL_PROCESS_HPP
+#define POAC_UTIL_PROCESS_HPP
+
+#include <string>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <list>
+#include <variant>
+#include <optional>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+
+
+// Run a program with an argument vector, without /bin/sh.
+// (util::command is kept for commands which need a shell.)
+namespace poac::util::process {
+    // Resources used by a child process (from wait4)
+    struct usage {
+        double wall_time = 0.0; // seconds
+        double user_time = 0.0;
+        double system_time = 0.0;
+        long max_rss = 0; // KiB
+    };
+
+    struct result {
+        int exit_code; // 128 + signal number if terminated by a signal, 127 if it could not be started
+        std::string out;
+        std::string err; // Empty if stderr is merged into out
+        process::usage usage = {};
+
+        bool success() const { return exit_code == 0; }
+    };
+
+    struct options {
+        std::optional<boost::filesystem::path> cwd = std::nullopt;
+        bool stderr_to_stdout = false;
+    };
+
+    // Like `command -v`, but without a shell.
+    std::optional<std::string> find_executable(const std::string& name) {
+        namespace fs = boost::filesystem;
+        if (name.find('/') != std::string::npos) {
+            if (::access(name.c_str(), X_OK) == 0) {
+                return name;
+            }
+            return std::nullopt;
+        }
+        const char* path = std::getenv("PATH");
+        std::string dirs = path ? path : "/usr/bin:/bin";
+        for (std::string::size_type first = 0, last; first <= dirs.size(); first = last + 1) {
+            last = dirs.find(':', first);
+            if (last == std::string::npos) {
+                last = dirs.size();
+            }
+            const fs::path dir = (last == first) ? "." : dirs.substr(first, last - first);
+            const fs::path candidate = dir / name;
+            boost::system::error_code error;
+            if (fs::is_regular_file(candidate, error) && ::access(candidate.c_str(), X_OK) == 0) {
+                return candidate.string();
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string to_string(const std::vector<std::string>& argv) {
+        std::string s;
+        for (const auto& a : argv) {
+            if (!s.empty()) {
+                s += ' ';
+            }
+            s += a;
+        }
+        return s;
+    }
+
+    namespace detail {
+        // Pipes are created and the child is forked under this lock, so that
+        //  a child forked by another thread never inherits them before FD_CLOEXEC is set.
+        std::mutex& spawn_mutex() {
+            static std::mutex m;
+            return m;
+        }
+
+        bool make_pipe(std::array<int, 2>& fds) {
+#ifdef __linux__
+            return ::pipe2(fds.data(), O_CLOEXEC) == 0;
+#else
+            if (::pipe(fds.data()) != 0) {
+                return false;
+            }
+            for (const int fd : fds) {
+                if (::fcntl(fd, F_SETFD, FD_CLOEXEC) != 0) {
+                    ::close(fds[0]);
+                    ::close(fds[1]);
+                    fds = { -1, -1 };
+                    return false;
+                }
+            }
+            return true;
+#endif
+        }
+
+        void close_pipe(std::array<int, 2>& fds) {
+            for (int& fd : fds) {
+                if (fd >= 0) {
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+        }
+
+        double to_seconds(const timeval& tv) {
+            return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1e6;
+        }
+
+        int wait(const pid_t pid, usage& u) {
+            int status = 0;
+            struct rusage ru{};
+            while (::wait4(pid, &status, 0, &ru) < 0) {
+                if (errno != EINTR) {
+                    return 127;
+                }
+            }
+            u.user_time = to_seconds(ru.ru_utime);
+            u.system_time = to_seconds(ru.ru_stime);
+#ifdef __APPLE__
+            u.max_rss = ru.ru_maxrss / 1024; // in bytes on macOS
+#else
+            u.max_rss = ru.ru_maxrss;
+#endif
+            if (WIFEXITED(status)) {
+                return WEXITSTATUS(status);
+            }
+            if (WIFSIGNALED(status)) {
+                return 128 + WTERMSIG(status);
+            }
+            return 127;
+        }
+
+        struct child {
+            pid_t pid = -1;
+            int out_fd = -1;
+            int err_fd = -1; // -1 if stderr is merged into stdout
+            std::chrono::steady_clock::time_point start;
+            std::string out;
+            std::string err;
+        };
+
+        // Start a child process whose stdout and stderr are connected to pipes.
+        // Returns an error message if it could not be started.
+        std::variant<child, std::string>
+        spawn(const std::vector<std::string>& argv, const options& opts) {
+            if (argv.empty()) {
+                return std::string("empty command\n");
+            }
+            const auto executable = find_executable(argv[0]);
+            if (!executable) {
+                return argv[0] + ": command not found\n";
+            }
+            // Everything which allocates is done before fork.
+            std::vector<char*> args;
+            for (const auto& a : argv) {
+                args.push_back(const_cast<char*>(a.c_str()));
+            }
+            args.push_back(nullptr);
+            const std::string cwd = opts.cwd ? opts.cwd->string() : "";
+
+            std::array<int, 2> out_pipe{ -1, -1 };
+            std::array<int, 2> err_pipe{ -1, -1 };
+            pid_t pid;
+            {
+                std::lock_guard<std::mutex> lock(spawn_mutex());
+                if (!make_pipe(out_pipe) || (!opts.stderr_to_stdout && !make_pipe(err_pipe))) {
+                    close_pipe(out_pipe);
+                    close_pipe(err_pipe);
+                    return std::string("pipe failed\n");
+                }
+                pid = ::fork();
+                if (pid == 0) {
+                    // Only async-signal-safe functions are allowed here.
+                    ::dup2(out_pipe[1], STDOUT_FILENO);
+                    ::dup2(opts.stderr_to_stdout ? out_pipe[1] : err_pipe[1], STDERR_FILENO);
+                    if (!cwd.empty() && ::chdir(cwd.c_str()) != 0) {
+                        constexpr char message[] = "cannot change the working directory\n";
+                        [[maybe_unused]] const auto written = ::write(STDERR_FILENO, message, sizeof(message) - 1);
+                        ::_exit(127);
+                    }
+                    ::execv(executable->c_str(), args.data());
+                    ::_exit(127);
+                }
+            }
+            // The parent keeps only the read ends.
+            ::close(out_pipe[1]);
+            if (err_pipe[1] >= 0) {
+                ::close(err_pipe[1]);
+            }
+            if (pid < 0) {
+                ::close(out_pipe[0]);
+                if (err_pipe[0] >= 0) {
+                    ::close(err_pipe[0]);
+                }
+                return std::string("fork failed\n");
+            }
+            child c;
+            c.pid = pid;
+            c.out_fd = out_pipe[0];
+            c.err_fd = err_pipe[0];
+            c.start = std::chrono::steady_clock::now();
+            return c;
+        }
+
+        // Read a large chunk. The descriptor is closed at EOF.
+        void read_some(int& fd, std::string& buf) {
+            static thread_local std::array<char, 65536> buffer;
+            const ssize_t n = ::read(fd, buffer.data(), buffer.size());
+            if (n > 0) {
+                buf.append(buffer.data(), static_cast<std::size_t>(n));
+            }
+            else if (n == 0 || errno != EINTR) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        // Wait for output of all children with one poll.
+        template <typename Children>
+        bool poll_children(Children& children) {
+            std::vector<pollfd> fds;
+            std::vector<std::pair<child*, bool>> owners; // (child, is stdout)
+            for (child& c : children) {
+                if (c.out_fd >= 0) {
+                    fds.push_back({ c.out_fd, POLLIN, 0 });
+                    owners.emplace_back(&c, true);
+                }
+                if (c.err_fd >= 0) {
+                    fds.push_back({ c.err_fd, POLLIN, 0 });
+                    owners.emplace_back(&c, false);
+                }
+            }
+            if (fds.empty()) {
+                return true;
+            }
+            if (::poll(fds.data(), fds.size(), -1) < 0) {
+                return errno == EINTR;
+            }
+            for (std::size_t i = 0; i < fds.size(); ++i) {
+                if (fds[i].revents != 0) {
+                    auto [c, is_out] = owners[i];
+                    if (is_out) {
+                        read_some(c->out_fd, c->out);
+                    }
+                    else {
+                        read_some(c->err_fd, c->err);
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool is_closed(const child& c) {
+            return c.out_fd < 0 && c.err_fd < 0;
+        }
+
+        result finish(child& c) {
+            // Descriptors are left open by a poll failure.
+            // Closing them lets the child fail to write (EPIPE) instead of blocking on a full pipe.
+            for (int* fd : { &c.out_fd, &c.err_fd }) {
+                if (*fd >= 0) {
+                    ::close(*fd);
+                    *fd = -1;
+                }
+            }
+            result res{ 0, std::move(c.out), std::move(c.err) };
+            res.exit_code = wait(c.pid, res.usage);
+            res.usage.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - c.start).count();
+            return res;
+        }
+
+        // The error is reported like the output of a child, which is in out if stderr is merged.
+        result spawn_error(const std::string& error, const options& opts) {
+            if (opts.stderr_to_stdout) {
+                return { 127, error, "" };
+            }
+            return { 127, "", error };
+        }
+    }
+
+    result run(const std::vector<std::string>& argv, const options& opts = {}) {
+        auto spawned = detail::spawn(argv, opts);
+        if (const auto error = std::get_if<std::string>(&spawned)) {
+            return detail::spawn_error(*error, opts);
+        }
+        std::array<detail::child, 1> children{ std::move(std::get<detail::child>(spawned)) };
+        while (!detail::is_closed(children[0]) && detail::poll_children(children));
+        return detail::finish(children[0]);
+    }
+
+    struct job {
+        std::vector<std::string> argv;
+        process::options options = {};
+    };
+
+    // Run jobs with at most `limit` children at a time.
+    // Outputs of all children are multiplexed with poll on the calling thread,
+    //  and `on_complete(index, result)` is called there as soon as each job exits.
+    void run_all(
+            const std::vector<job>& jobs,
+            const unsigned int limit,
+            const std::function<void(std::size_t, const result&)>& on_complete)
+    {
+        std::list<detail::child> children;
+        std::list<std::size_t> indices;
+        std::size_t next = 0;
+
+        while (next < jobs.size() || !children.empty()) {
+            while (next < jobs.size() && children.size() < std::max(limit, 1u)) {
+                const std::size_t i = next++;
+                auto spawned = detail::spawn(jobs[i].argv, jobs[i].options);
+                if (const auto error = std::get_if<std::string>(&spawned)) {
+                    on_complete(i, detail::spawn_error(*error, jobs[i].options));
+                    continue;
+                }
+                children.push_back(std::move(std::get<detail::child>(spawned)));
+                indices.push_back(i);
+            }
+            if (!detail::poll_children(children)) {
+                break;
+            }
+            auto index = indices.begin();
+            for (auto c = children.begin(); c != children.end();) {
+                if (detail::is_closed(*c)) {
+                    on_complete(*index, detail::finish(*c));
+                    c = children.erase(c);
+                    index = indices.erase(index);
+                }
+                else {
+                    ++c;
+                    ++index;
+                }
+            }
+        }
+        // After a poll failure, the running children are reaped and the others are not started,
+        //  so that every job is still completed once.
+        auto index = indices.begin();
+        for (auto c = children.begin(); c != children.end(); ++c, ++index) {
+            on_complete(*index, detail::finish(*c));
+        }
+        for (; next < jobs.size(); ++next) {
+            on_complete(next, detail::spawn_error("poll failed\n", jobs[next].options));
+        }
+    }
+} // end namespace
+#endif // !POAC_UTIL_PROCESS_HPP
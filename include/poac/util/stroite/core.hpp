@@ -2,7 +2,17 @@
 #define STROITE_CORE_HPP
 
 #include "core/builder.hpp"
+#include "core/compile_commands.hpp"
 #include "core/compiler.hpp"
 #include "core/depends.hpp"
+#include "core/includes.hpp"
+#include "core/memo.hpp"
+#include "core/object_cache.hpp"
+#include "core/pgo.hpp"
+#include "core/profile.hpp"
+#include "core/scheduler.hpp"
+#include "core/state.hpp"
+#include "core/toolchain.hpp"
+#include "core/trace.hpp"
 
 #endif // STROITE_CORE_HPP
\ No newline at end of file
@@ -11,13 +11,25 @@
 #include <list>
 #include <algorithm>
 #include <map>
+#include <set>
 #include <optional>
+#include <cstdint>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include "./compile_commands.hpp"
 #include "./compiler.hpp"
 #include "./depends.hpp"
+#include "./memo.hpp"
+#include "./object_cache.hpp"
+#include "./pgo.hpp"
+#include "./profile.hpp"
+#include "./scheduler.hpp"
+#include "./state.hpp"
+#include "./toolchain.hpp"
+#include "./trace.hpp"
+#include "./includes.hpp"
 #include "../utils.hpp"
 
 #include "../../../core/exception.hpp"
@@ -39,10 +51,33 @@ namespace stroite {
         std::string project_name;
         boost::filesystem::path base_dir;
 
+        using fingerprint = core::state::fingerprint;
+
         std::map<std::string, YAML::Node> node;
-        std::map<std::string, std::map<std::string, std::string>> depends_ts;
+        std::map<std::string, std::map<std::string, fingerprint>> depends_fp;
+        // Including sources which are up to date (compile_conf.source_files has only those to be compiled)
+        std::vector<std::string> all_source_files;
         std::optional<std::map<std::string, YAML::Node>> deps_node;
+        // --unity
+        bool unity = false;
+        // --release, --profile <name>
+        core::profile::settings profile;
+        // Compiling position independent objects for the shared library
+        bool pic = false;
+
 
+        boost::filesystem::path to_profile_dir(const boost::filesystem::path& p) {
+            return core::profile::to_dir(p, profile.name);
+        }
+        // _build/_cache/obj -> _build/_cache/pic/obj, so that objects of the static and
+        //  the shared library (and their build states) never overwrite each other.
+        boost::filesystem::path to_cache_dir(const boost::filesystem::path& p) {
+            namespace path = poac::io::file::path;
+            if (pic) {
+                return to_profile_dir(path::current_build_cache_pic_dir / p.lexically_relative(path::current_build_cache_dir));
+            }
+            return to_profile_dir(p);
+        }
 
         bool is_cpp_file(const boost::filesystem::path& p) {
             namespace fs = boost::filesystem;
@@ -68,6 +103,58 @@ namespace stroite {
             return source_files;
         }
 
+        // build: unity: N, or --unity (N is the number of hardware threads by default)
+        unsigned int make_unity_batches() {
+            namespace yaml = poac::io::file::yaml;
+            if (const auto batches = yaml::get<unsigned int>(node.at("build"), "unity")) {
+                return *batches;
+            }
+            return unity ? core::scheduler::default_jobs() : 0;
+        }
+
+        // Sources are batched into generated translation units which include them.
+        // A source belongs to the batch chosen by the hash of its path, so that
+        //  adding or removing a source changes only one batch, and
+        //  the unchanged batches are not recompiled.
+        auto make_unity_source_files(const std::vector<std::string>& source_files, const unsigned int batches) {
+            namespace fs = boost::filesystem;
+            namespace io = poac::io::file;
+            namespace hash = utils::hash;
+
+            std::vector<std::vector<std::string>> buckets(batches);
+            for (const auto& s : source_files) {
+                buckets[hash::string(fs::relative(s, base_dir).generic_string()) % batches].push_back(s);
+            }
+
+            const fs::path unity_dir = to_profile_dir(io::path::current_build_cache_unity_dir) / project_name;
+            fs::create_directories(unity_dir);
+            std::vector<std::string> unity_files;
+            for (std::size_t i = 0; i < buckets.size(); ++i) {
+                if (buckets[i].empty()) {
+                    continue;
+                }
+                const fs::path unity_file = unity_dir / ("unity_" + std::to_string(i) + ".cpp");
+                std::sort(buckets[i].begin(), buckets[i].end());
+                std::string content = "// Generated by poac. Do not edit.\n";
+                for (const auto& s : buckets[i]) {
+                    content += "#include \"" + fs::absolute(s).string() + "\"\n";
+                }
+                // Rewriting the same content would only change mtime.
+                if (io::path::read_file(unity_file) != content) {
+                    std::ofstream(unity_file.string()) << content;
+                }
+                unity_files.push_back(unity_file.string());
+            }
+            // Remove batches which are no longer used (e.g. N is decreased).
+            for (const fs::path& p : fs::directory_iterator(unity_dir)) {
+                if (std::find(unity_files.begin(), unity_files.end(), p.string()) == unity_files.end()) {
+                    boost::system::error_code error;
+                    fs::remove(p, error);
+                }
+            }
+            return unity_files;
+        }
+
         auto make_include_search_path() {
             namespace fs = boost::filesystem;
             namespace naming = poac::core::naming;
@@ -113,100 +200,166 @@ namespace stroite {
             return macro_defns;
         }
 
+        // Arguments of the profile follow build: compile_args, so that they can override them.
         auto make_compile_other_args() {
             namespace yaml = poac::io::file::yaml;
+            std::vector<std::string> args;
             if (const auto compile_args = yaml::get<std::vector<std::string>>(node.at("build"), "compile_args")) {
-                return *compile_args;
+                args = *compile_args;
             }
-            else {
-                return std::vector<std::string>{};
+            args.insert(args.end(), profile.compile_args.begin(), profile.compile_args.end());
+            if (profile.lto) {
+                const auto lto = core::profile::lto_compile_args(core::toolchain::get(system).is_clang);
+                args.insert(args.end(), lto.begin(), lto.end());
+            }
+            const auto debug = core::profile::debug_compile_args(profile);
+            args.insert(args.end(), debug.begin(), debug.end());
+            const auto visibility = make_visibility_args();
+            args.insert(args.end(), visibility.begin(), visibility.end());
+            if (pic) {
+                args.push_back("-fPIC");
+            }
+            return args;
+        }
+
+        // build: visibility: hidden
+        // Only symbols marked __attribute__((visibility("default"))) are exported from the shared library,
+        //  which makes its dynamic symbol table smaller and loading faster.
+        std::vector<std::string> make_visibility_args() {
+            namespace exception = poac::core::exception;
+            namespace yaml = poac::io::file::yaml;
+            const auto visibility = yaml::get<std::string>(node.at("build"), "visibility");
+            if (!visibility || *visibility == "default") {
+                return {};
+            }
+            else if (*visibility == "hidden") {
+                return { "-fvisibility=hidden", "-fvisibility-inlines-hidden" };
             }
+            throw exception::error(
+                    "Invalid visibility: `" + *visibility + "`\n"
+                    "build: visibility must be `default` or `hidden`.");
         }
 
 
-        std::string to_cache_hash_path(const std::string& s) {
+        // Sources are recorded in the build state by the path relative to the project root.
+        std::string to_state_key(const std::string& s) {
             namespace fs = boost::filesystem;
-            namespace io = poac::io::file;
+            return fs::relative(s).string();
+        }
 
-            const auto hash_path = io::path::current_build_cache_hash_dir / fs::relative(s);
-            return hash_path.string() + ".hash";
+        core::state::database& build_state() {
+            return core::state::open(to_cache_dir(poac::io::file::path::current_build_cache_state));
         }
 
-        std::optional<std::map<std::string, std::string>>
-        load_timestamps(const std::string& src_cpp_hash) {
-            namespace io = poac::io::file;
+        // A pseudo entry which holds the hash of the compile command line,
+        //  so that changing flags also causes recompilation.
+        static inline const std::string command_key = "<command>";
+        // The time of the last compilation of a source is kept in the target `time_key + source`
+        //  as the size of the entry time_key (in microseconds). (see core::includes)
+        static inline const std::string time_key = core::includes::time_key;
 
-            std::ifstream ifs(src_cpp_hash);
-            if(!ifs.is_open()){
-                return std::nullopt;
-            }
+        std::optional<std::map<std::string, fingerprint>>
+        load_fingerprints(const std::string& key) {
+            return build_state().get(key);
+        }
 
-            std::string buff;
-            std::map<std::string, std::string> hash;
-            while (std::getline(ifs, buff)) {
-                const auto list_string = io::path::split(buff, ": \n");
-                hash[list_string[0]] = list_string[1];
-            }
-            return hash;
+        void save_fingerprints(
+                const std::string& key,
+                const std::map<std::string, fingerprint>& fps)
+        {
+            build_state().put(key, fps);
         }
 
-        void generate_timestamp(
+        // Files are identified by the hash of their contents, so that a fresh checkout
+        //  (which touches every mtime) does not cause recompilation.
+        // mtime and size are only used to skip re-hashing of files which are not touched.
+        void generate_fingerprint(
                 const std::string& filename,
-                std::map<std::string, std::string>& timestamp)
+                const std::optional<std::map<std::string, fingerprint>>& previous,
+                std::map<std::string, fingerprint>& fps)
         {
-            namespace fs = boost::filesystem;
-            namespace io = poac::io::file;
-
-            boost::system::error_code error;
-            const std::time_t last_time = fs::last_write_time(filename, error);
-            timestamp.emplace(filename, std::to_string(last_time));
+            std::optional<fingerprint> previous_fp;
+            if (previous) {
+                if (const auto itr = previous->find(filename); itr != previous->end()) {
+                    previous_fp = itr->second;
+                }
+            }
+            fps.emplace(filename, core::memo::fingerprints().get(filename, previous_fp));
         }
 
         // *.cpp -> hash
-        std::optional<std::map<std::string, std::string>>
-        generate_timestamps(const std::string& source_file)
+        std::optional<std::map<std::string, fingerprint>>
+        generate_fingerprints(
+                const std::string& source_file,
+                const std::optional<std::map<std::string, fingerprint>>& previous)
         {
+            namespace hash = utils::hash;
+
             if (const auto deps_headers = core::depends::gen(compile_conf, source_file))
             {
-                std::map<std::string, std::string> hash;
+                std::map<std::string, fingerprint> fps;
                 for (const auto& name : *deps_headers) {
                     // Calculate the hash of the source dependent files.
-                    generate_timestamp(name, hash);
+                    generate_fingerprint(name, previous, fps);
                 }
                 // Calculate the hash of the source file itself.
-                generate_timestamp(source_file, hash);
-                return hash;
+                generate_fingerprint(source_file, previous, fps);
+                // Profile data (PGO) which the source is compiled with
+                for (const auto& p : core::compiler::to_profile_data_paths(compile_conf, source_file)) {
+                    generate_fingerprint(p, previous, fps);
+                }
+                // Calculate the hash of the command line.
+                // Headers in the precompiled header are not listed in the dependency file.
+                // The compiler identity makes an upgraded compiler rebuild everything.
+                const std::string command = core::object_cache::compiler_identity(system)
+                        + utils::options::to_string(compile_conf) + compile_conf.pch_digest;
+                fps[command_key] = { hash::string(command), 0, 0 };
+                return fps;
             }
             return std::nullopt;
         }
 
+        bool is_same_contents(
+                const std::map<std::string, fingerprint>& lhs,
+                const std::map<std::string, fingerprint>& rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                    [](const auto& l, const auto& r) { return l.first == r.first && l.second.hash == r.second.hash; });
+        }
+
         auto check_src_cpp(const std::vector<std::string>& source_files)
         {
             namespace fs = boost::filesystem;
 
             std::vector<std::string> new_source_files;
             for (const auto& sf : source_files) {
-                if (const auto previous_ts = load_timestamps(to_cache_hash_path(sf))) {
-                    if (const auto current_ts = generate_timestamps(sf))
+                const auto key = to_state_key(sf);
+                const auto previous_fps = load_fingerprints(key);
+                // Without the dependency file of the last compilation,
+                //  it is unknown which headers the source depends on.
+                if (const auto current_fps = previous_fps ? generate_fingerprints(sf, previous_fps) : std::nullopt) {
+                    if (!is_same_contents(*previous_fps, *current_fps)
+                        || !fs::exists(core::compiler::to_obj_path(compile_conf, sf))
+                        || (core::compiler::is_split_dwarf(compile_conf)
+                            && !fs::exists(core::compiler::to_dwo_path(compile_conf, sf))))
                     {
                         // Since hash of already existing hash file
                         //  does not match hash of current cpp file,
-                        //  it does not exclude it from compilation,
-                        //  and generates hash for overwriting.
-                        if (*previous_ts != *current_ts) {
-                            depends_ts[to_cache_hash_path(sf)] = *current_ts;
-                            new_source_files.push_back(sf);
-                        }
+                        //  it does not exclude it from compilation.
+                        depends_fp[key] = *current_fps;
+                        new_source_files.push_back(sf);
                     }
-                }
-                else {
-                    // Since hash file does not exist, generates hash and compiles source file.
-                    if (const auto cur_hash = generate_timestamps(sf))
+                    else if (!std::equal(previous_fps->begin(), previous_fps->end(), current_fps->begin(),
+                            [](const auto& l, const auto& r) { return l.second.mtime == r.second.mtime; }))
                     {
-                        depends_ts[to_cache_hash_path(sf)] = *cur_hash;
-                        new_source_files.push_back(sf);
+                        // Contents are the same, but files have been touched.
+                        // Update mtime so that they are not re-hashed next time.
+                        save_fingerprints(key, *current_fps);
                     }
                 }
+                else {
+                    new_source_files.push_back(sf);
+                }
             }
             return new_source_files;
         }
@@ -226,50 +379,193 @@ namespace stroite {
                     source_files.push_back("main.cpp");
                 }
             }
+            all_source_files = source_files;
+            core::trace::span span("fingerprint " + project_name, "phase");
             return check_src_cpp(source_files);
         }
 
-        void configure_compile(const bool usemain, const bool verbose)
+        // build: pch: <header>
+        // The header is precompiled once with the same flags as translation units,
+        //  and force-included into all of them through a wrapper header in _build/_cache/pch,
+        //  next to which the compiler looks for the precompiled one.
+        void configure_pch() {
+            namespace fs = boost::filesystem;
+            namespace exception = poac::core::exception;
+            namespace yaml = poac::io::file::yaml;
+            namespace io = poac::io::file;
+            namespace hash = utils::hash;
+
+            compile_conf.pch_digest.clear();
+            const auto header = yaml::get<std::string>(node.at("build"), "pch");
+            if (!header) {
+                return;
+            }
+            const fs::path header_path = fs::absolute(*header, base_dir);
+            if (!fs::exists(header_path)) {
+                throw exception::error("Precompiled header `" + *header + "` does not exist");
+            }
+
+            const fs::path wrapper =
+                    to_cache_dir(io::path::current_build_cache_pch_dir) / project_name / header_path.filename();
+            const std::string content = "#include \"" + header_path.string() + "\"\n";
+            if (io::path::read_file(wrapper) != content) {
+                fs::create_directories(wrapper.parent_path());
+                std::ofstream(wrapper.string()) << content;
+            }
+            const std::string output = wrapper.string() + (core::toolchain::get(system).is_clang ? ".pch" : ".gch");
+            const std::string dep_path = wrapper.string() + ".d";
+
+            const auto key = to_state_key(output);
+            const auto previous = load_fingerprints(key);
+            auto current = previous && fs::exists(output) ? generate_pch_fingerprints(dep_path, previous) : std::nullopt;
+            if (!current || !is_same_contents(*previous, *current)) {
+                if (!core::compiler::compile_pch(compile_conf, wrapper.string(), output, dep_path)) {
+                    throw exception::error("Failed to precompile `" + *header + "`");
+                }
+                current = generate_pch_fingerprints(dep_path, previous);
+                if (current) {
+                    save_fingerprints(key, *current);
+                }
+            }
+
+            std::string hashes;
+            if (current) {
+                for (const auto& [path, fp] : *current) {
+                    hashes += path + hash::to_hex(fp.hash);
+                }
+            }
+            compile_conf.pch_digest = hash::to_hex(hash::string(hashes));
+            // -Winvalid-pch: Warn if a precompiled header is found but can not be used.
+            compile_conf.other_args.push_back("-Winvalid-pch");
+            // -fpch-preprocess (GCC): The output of -E refers to the precompiled header instead of expanding it,
+            //  so that the object cache identifies the header by pch_digest.
+            if (!core::toolchain::get(system).is_clang) {
+                compile_conf.other_args.push_back("-fpch-preprocess");
+            }
+            compile_conf.other_args.push_back("-include");
+            compile_conf.other_args.push_back(wrapper.string());
+        }
+
+        std::optional<std::map<std::string, fingerprint>>
+        generate_pch_fingerprints(
+                const std::string& dep_path,
+                const std::optional<std::map<std::string, fingerprint>>& previous)
         {
+            namespace hash = utils::hash;
+
+            if (const auto deps_headers = core::depends::read(dep_path, base_dir)) {
+                std::map<std::string, fingerprint> fps;
+                for (const auto& name : *deps_headers) {
+                    generate_fingerprint(name, previous, fps);
+                }
+                const std::string command = core::object_cache::compiler_identity(system)
+                        + utils::options::to_string(compile_conf);
+                fps[command_key] = { hash::string(command), 0, 0 };
+                return fps;
+            }
+            return std::nullopt;
+        }
+
+        // Fails early instead of an error of the compiler for each translation unit.
+        void check_cpp_version(const unsigned int cpp_version) {
+            namespace exception = poac::core::exception;
+            const auto& probe = core::toolchain::get(system);
+            const auto& levels = core::toolchain::std_levels;
+            if (!probe.std_levels.empty()
+                && std::find(levels.begin(), levels.end(), cpp_version) != levels.end()
+                && !probe.supports(cpp_version))
+            {
+                throw exception::error(
+                        "`" + system + "` does not support C++" + std::to_string(cpp_version) + ".\n"
+                        "Select another compiler by the environment variable \"CXX\".");
+            }
+        }
+
+        // Entries are of the original sources even in a unity build, since tools work on them.
+        void update_compile_commands(const bool usemain) {
+            namespace fs = boost::filesystem;
+            auto source_files = make_source_files();
+            if (usemain && fs::exists(base_dir / "main.cpp")) {
+                source_files.push_back("main.cpp");
+            }
+            const auto flags = utils::options::to_args(compile_conf);
+            std::vector<core::compile_commands::entry> entries;
+            for (const auto& s : source_files) {
+                entries.push_back({
+                    fs::absolute(base_dir).string(),
+                    fs::absolute(s, base_dir).string(),
+                    core::compiler::to_obj_path(compile_conf, s),
+                    core::compiler::make_tu_args(compile_conf, flags, s)
+                });
+            }
+            core::compile_commands::open(poac::io::file::path::current_build_compile_commands)
+                    .update(fs::absolute(base_dir).string(), entries);
+        }
+
+        void configure_compile(
+                const bool usemain,
+                const bool verbose,
+                const unsigned int jobs = core::scheduler::default_jobs() )
+        {
+            core::trace::span span("configure " + project_name, "phase");
             compile_conf.system = system;
             compile_conf.version_prefix = utils::configure::default_version_prefix();
             // TODO: 存在することが確約されているときのyaml::get
             compile_conf.cpp_version = node.at("cpp_version").as<unsigned int>();
+            check_cpp_version(compile_conf.cpp_version);
             compile_conf.include_search_path = make_include_search_path();
             compile_conf.other_args = make_compile_other_args();
             compile_conf.verbose = verbose;
-            compile_conf.source_files = hash_source_files(make_source_files(), usemain);
             compile_conf.macro_defns = make_macro_defns();
             compile_conf.base_dir = base_dir;
-            compile_conf.output_root = poac::io::file::path::current_build_cache_obj_dir;
+            compile_conf.output_root = to_cache_dir(poac::io::file::path::current_build_cache_obj_dir);
+            compile_conf.jobs = jobs;
+            compile_conf.profile_use = profile.profile_use;
+            compile_conf.profile_data = profile.profile_data;
+            configure_pch();
+            // The command line is a part of the fingerprints, so this must be last.
+            if (const auto batches = make_unity_batches(); batches != 0) {
+                compile_conf.source_files = hash_source_files(make_unity_source_files(make_source_files(), batches), usemain);
+            }
+            else {
+                compile_conf.source_files = hash_source_files(make_source_files(), usemain);
+            }
+            // Tools are given the command lines of the static objects.
+            if (!pic) {
+                update_compile_commands(usemain);
+            }
+        }
+        // Objects of unchanged sources are also needed for linking.
+        std::vector<std::string> obj_files() {
+            std::vector<std::string> obj_files_path;
+            for (const auto& s : all_source_files) {
+                obj_files_path.push_back(core::compiler::to_obj_path(compile_conf, s));
+            }
+            return obj_files_path;
         }
+
         std::optional<std::vector<std::string>>
         _compile() {
             namespace io = poac::io::file;
 
-            if (const auto ret = core::compiler::compile(compile_conf)) {
-                namespace fs = boost::filesystem;
-                // Since compile succeeded, save hash
-                std::ofstream ofs;
-                for (const auto& [hash_name, data] : depends_ts) {
-                    std::string output_string;
-                    for (const auto& [fname, hash] : data) {
-                        output_string += fname + ": " + hash + "\n";
+            std::vector<double> durations;
+            if (const auto ret = core::compiler::compile(compile_conf, durations)) {
+                // Since compile succeeded, save hash of the dependencies
+                //  which the compiler has just written out.
+                for (std::size_t i = 0; i < compile_conf.source_files.size(); ++i) {
+                    const auto& s = compile_conf.source_files[i];
+                    const auto key = to_state_key(s);
+                    if (const auto fps = generate_fingerprints(s, depends_fp[key])) {
+                        save_fingerprints(key, *fps);
+                    }
+                    if (durations[i] >= 0.0) {
+                        const auto us = static_cast<std::uint64_t>(durations[i] * 1e6);
+                        save_fingerprints(time_key + key, { { time_key, { 0, 0, us } } });
                     }
-                    fs::create_directories(fs::path(hash_name).parent_path());
-                    io::path::write_to_file(ofs, hash_name, output_string);
                 }
                 // Because it is excluded for the convenience of cache,
                 //  ignore the return value of compiler.compile.
-                std::vector<std::string> obj_files;
-                for (const auto& s : compile_conf.source_files) {
-                    obj_files.push_back(
-                            (compile_conf.output_root / fs::relative(s))
-                                    .replace_extension("o")
-                                    .string()
-                    );
-                }
-                return obj_files;
+                return obj_files();
             }
             else {
                 return std::nullopt;
@@ -278,12 +574,42 @@ namespace stroite {
 
         auto make_link_other_args() {
             namespace yaml = poac::io::file::yaml;
+            std::vector<std::string> args;
             if (const auto link_args = yaml::get<std::vector<std::string>>(node.at("build"), "link_args")) {
-                return *link_args;
+                args = *link_args;
             }
-            else {
-                return std::vector<std::string>{};
+            args.insert(args.end(), profile.link_args.begin(), profile.link_args.end());
+            if (profile.lto) {
+                const auto lto = core::profile::lto_link_args(core::toolchain::get(system).is_clang, compile_conf.jobs);
+                args.insert(args.end(), lto.begin(), lto.end());
+            }
+            const auto linker = make_linker_args();
+            args.insert(args.end(), linker.begin(), linker.end());
+            const auto debug = core::profile::debug_link_args(profile);
+            args.insert(args.end(), debug.begin(), debug.end());
+            return args;
+        }
+        // build: linker: lld (or gold, mold, bfd)
+        // It is a part of the command line, and so of the fingerprints of linked outputs.
+        std::vector<std::string> make_linker_args() {
+            namespace exception = poac::core::exception;
+            namespace yaml = poac::io::file::yaml;
+            const auto linker = yaml::get<std::string>(node.at("build"), "linker");
+            if (linker && *linker != "lld" && *linker != "gold" && *linker != "mold" && *linker != "bfd") {
+                throw exception::error(
+                        "Invalid linker: `" + *linker + "`\n"
+                        "build: linker must be one of lld, gold, mold and bfd.");
+            }
+            // GNU ld (bfd) can not write the index.
+            if (profile.gdb_index && (!linker || *linker == "bfd")) {
+                throw exception::error(
+                        "gdb_index of the profile `" + profile.name + "` needs another linker.\n"
+                        "Select it by build: linker (lld, gold or mold).");
+            }
+            if (!linker) {
+                return {};
             }
+            return { "-fuse-ld=" + *linker };
         }
         // TODO: Divide it finer...
         auto make_link() {
@@ -326,7 +652,7 @@ namespace stroite {
 
                     else {
                         const std::string pkgname = name2;
-                        const fs::path pkgpath = poac::io::file::path::current_build_lib_dir / pkgname;
+                        const fs::path pkgpath = to_profile_dir(poac::io::file::path::current_build_lib_dir) / pkgname;
 
                         // TODO: dynamic libを指定できるように
                         if (const auto lib_dir = pkgpath.string() + ".a"; fs::exists(lib_dir)) {
@@ -343,7 +669,7 @@ namespace stroite {
         {
             link_conf.system = system;
             link_conf.project_name = project_name;
-            link_conf.output_root = poac::io::file::path::current_build_bin_dir;
+            link_conf.output_root = to_profile_dir(poac::io::file::path::current_build_bin_dir);
             link_conf.obj_files_path = obj_files_path;
             const auto links = make_link();
             link_conf.library_search_path = std::get<0>(links);
@@ -352,9 +678,65 @@ namespace stroite {
             link_conf.other_args = make_link_other_args();
             link_conf.verbose = verbose;
         }
+        // The output of linking is recorded in the build state with fingerprints of
+        //  its inputs and the command line, so that it is not linked again if they are unchanged.
+        std::map<std::string, fingerprint>
+        generate_link_fingerprints(
+                const std::vector<std::string>& inputs,
+                const std::string& command,
+                const std::optional<std::map<std::string, fingerprint>>& previous)
+        {
+            namespace hash = utils::hash;
+
+            std::map<std::string, fingerprint> fps;
+            for (const auto& i : inputs) {
+                generate_fingerprint(i, previous, fps);
+            }
+            fps[command_key] = { hash::string(command), 0, 0 };
+            return fps;
+        }
+
+        bool is_up_to_date(
+                const std::string& output,
+                const std::vector<std::string>& inputs,
+                const std::string& command)
+        {
+            namespace fs = boost::filesystem;
+            if (!fs::exists(output)) {
+                return false;
+            }
+            const auto previous = load_fingerprints(to_state_key(output));
+            return previous && is_same_contents(*previous, generate_link_fingerprints(inputs, command, previous));
+        }
+
+        void save_link_fingerprints(
+                const std::string& output,
+                const std::vector<std::string>& inputs,
+                const std::string& command)
+        {
+            const auto key = to_state_key(output);
+            save_fingerprints(key, generate_link_fingerprints(inputs, command, load_fingerprints(key)));
+        }
+
+        std::vector<std::string> link_inputs() {
+            auto inputs = link_conf.obj_files_path;
+            inputs.insert(inputs.end(), link_conf.library_path.begin(), link_conf.library_path.end());
+            return inputs;
+        }
+        std::string link_command() {
+            return system + " " + utils::options::to_string(link_conf);
+        }
+
+        bool is_up_to_date_link() {
+            return is_up_to_date(core::compiler::to_bin_path(link_conf), link_inputs(), link_command());
+        }
         auto _link()
         {
-            return core::compiler::link(link_conf);
+            const auto ret = core::compiler::link(link_conf);
+            if (ret) {
+                save_link_fingerprints(*ret, link_inputs(), link_command());
+            }
+            return ret;
         }
 
         void configure_static_lib(
@@ -363,13 +745,68 @@ namespace stroite {
         {
             namespace io = poac::io::file;
             static_lib_conf.project_name = project_name;
-            static_lib_conf.output_root = io::path::current_build_lib_dir;
+            static_lib_conf.output_root = to_profile_dir(io::path::current_build_lib_dir);
             static_lib_conf.obj_files_path = obj_files_path;
             static_lib_conf.verbose = verbose;
         }
+        static inline const std::string archive_command = "ar";
+
+        bool is_up_to_date_static_lib() {
+            return is_up_to_date(core::compiler::to_static_lib_path(static_lib_conf),
+                                 static_lib_conf.obj_files_path, archive_command);
+        }
+
+        bool has_same_basename(const std::vector<std::string>& obj_files_path) {
+            namespace fs = boost::filesystem;
+            std::set<std::string> basenames;
+            for (const auto& o : obj_files_path) {
+                if (!basenames.insert(fs::path(o).filename().string()).second) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Only members whose objects have changed are replaced in the existing archive.
+        // It is created from scratch if members can not be identified by their basename.
         auto _gen_static_lib()
         {
-            return core::compiler::gen_static_lib(static_lib_conf);
+            namespace fs = boost::filesystem;
+
+            const auto& objs = static_lib_conf.obj_files_path;
+            const auto stlib_path = core::compiler::to_static_lib_path(static_lib_conf);
+            const auto previous = load_fingerprints(to_state_key(stlib_path));
+            const auto current = generate_link_fingerprints(objs, archive_command, previous);
+
+            std::optional<std::string> ret;
+            if (previous && fs::exists(stlib_path)) {
+                std::vector<std::string> changed;
+                std::vector<std::string> removed;
+                for (const auto& [path, fp] : current) {
+                    if (const auto itr = previous->find(path); path != command_key
+                        && (itr == previous->end() || itr->second.hash != fp.hash))
+                    {
+                        changed.push_back(path);
+                    }
+                }
+                for (const auto& [path, fp] : *previous) {
+                    if (path != command_key && current.find(path) == current.end()) {
+                        removed.push_back(path);
+                    }
+                }
+                auto members = objs;
+                members.insert(members.end(), removed.begin(), removed.end());
+                if (!has_same_basename(members)) {
+                    ret = core::compiler::update_static_lib(static_lib_conf, changed, removed);
+                }
+            }
+            if (!ret) {
+                ret = core::compiler::gen_static_lib(static_lib_conf);
+            }
+            if (ret) {
+                save_fingerprints(to_state_key(stlib_path), current);
+            }
+            return ret;
         }
 
         void configure_dynamic_lib(
@@ -381,13 +818,54 @@ namespace stroite {
             dynamic_lib_conf.project_name = project_name;
             // outputを一箇所か分散か選べるように．boost::hoghoeみたいに，enumのオプションを渡すとOK
             // 一箇所ってのは，./ poac build -> ./_buildだけど，depsも./_buildに配置されるやつ
-            dynamic_lib_conf.output_root = io::path::current_build_lib_dir;
+            dynamic_lib_conf.output_root = to_profile_dir(io::path::current_build_lib_dir);
             dynamic_lib_conf.obj_files_path = obj_files_path;
+            dynamic_lib_conf.other_args = make_link_other_args();
+            if (const auto script = make_version_script()) {
+                dynamic_lib_conf.other_args.push_back("-Wl,--version-script=" + *script);
+            }
             dynamic_lib_conf.verbose = verbose;
         }
+        // build: version_script: <file>
+        // The linker exports only symbols listed in it (ld's version script).
+        std::optional<std::string> make_version_script() {
+            namespace fs = boost::filesystem;
+            namespace exception = poac::core::exception;
+            namespace yaml = poac::io::file::yaml;
+            const auto script = yaml::get<std::string>(node.at("build"), "version_script");
+            if (!script) {
+                return std::nullopt;
+            }
+#ifdef __APPLE__
+            throw exception::error("build: version_script is not supported by the linker of macOS.");
+#endif
+            const fs::path script_path = fs::absolute(*script, base_dir);
+            if (!fs::exists(script_path)) {
+                throw exception::error("Version script `" + *script + "` does not exist");
+            }
+            return script_path.string();
+        }
+        std::vector<std::string> dynamic_lib_inputs() {
+            auto inputs = dynamic_lib_conf.obj_files_path;
+            if (const auto script = make_version_script()) {
+                inputs.push_back(*script);
+            }
+            return inputs;
+        }
+        std::string dynamic_lib_command() {
+            return system + " " + utils::options::to_string(dynamic_lib_conf);
+        }
+        bool is_up_to_date_dynamic_lib() {
+            return is_up_to_date(core::compiler::to_dynamic_lib_path(dynamic_lib_conf),
+                                 dynamic_lib_inputs(), dynamic_lib_command());
+        }
         auto _gen_dynamic_lib()
         {
-            return core::compiler::gen_dynamic_lib(dynamic_lib_conf);
+            const auto ret = core::compiler::gen_dynamic_lib(dynamic_lib_conf);
+            if (ret) {
+                save_link_fingerprints(*ret, dynamic_lib_inputs(), dynamic_lib_command());
+            }
+            return ret;
         }
 
         // TODO: poac.ymlのhashもcheckしてほしい
@@ -0,0 +1,131 @@
+// JSON Compilation Database for clangd, clang-tidy and other tools
+#ifndef STROITE_CORE_COMPILE_COMMANDS_HPP
+#define STROITE_CORE_COMPILE_COMMANDS_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "../utils/misc.hpp"
+#include "../utils/registry.hpp"
+
+
+// (https://clang.llvm.org/docs/JSONCompilationDatabase.html)
+// Every package built in a project has its entries in one file, and
+//  each builder replaces only the entries of its own directory.
+// The file is rewritten only if an entry has changed,
+//  so that tools watching it do not reload it on every build.
+namespace stroite::core::compile_commands {
+    namespace fs = boost::filesystem;
+
+    struct entry {
+        std::string directory;
+        std::string file;
+        std::string output;
+        std::vector<std::string> arguments;
+    };
+    bool operator==(const entry& lhs, const entry& rhs) {
+        return lhs.directory == rhs.directory && lhs.file == rhs.file
+            && lhs.output == rhs.output && lhs.arguments == rhs.arguments;
+    }
+    bool operator!=(const entry& lhs, const entry& rhs) {
+        return !(lhs == rhs);
+    }
+
+    class database {
+    public:
+        explicit database(const fs::path& p) : file_path(p) {
+            load();
+        }
+
+        void update(const std::string& directory, const std::vector<entry>& updated) {
+            std::lock_guard<std::mutex> lock(mtx);
+            std::map<std::string, entry> next;
+            for (const auto& [file, e] : entries) {
+                if (e.directory != directory) {
+                    next.emplace(file, e);
+                }
+            }
+            for (const auto& e : updated) {
+                next[e.file] = e;
+            }
+            if (next != entries || !fs::exists(file_path)) {
+                entries = std::move(next);
+                write();
+            }
+        }
+
+    private:
+        fs::path file_path;
+        std::mutex mtx;
+        std::map<std::string, entry> entries; // file -> entry
+
+        // A broken file is regarded as empty, and is rewritten.
+        void load() {
+            namespace pt = boost::property_tree;
+            if (!fs::exists(file_path)) {
+                return;
+            }
+            try {
+                pt::ptree root;
+                pt::read_json(file_path.string(), root);
+                for (const auto& [key, child] : root) {
+                    entry e;
+                    e.directory = child.get<std::string>("directory");
+                    e.file = child.get<std::string>("file");
+                    e.output = child.get<std::string>("output", "");
+                    for (const auto& [k, a] : child.get_child("arguments")) {
+                        e.arguments.push_back(a.get_value<std::string>());
+                    }
+                    entries.emplace(e.file, std::move(e));
+                }
+            }
+            catch (...) {
+                entries.clear();
+            }
+        }
+
+        static std::string quote(const std::string& s) {
+            return "\"" + utils::misc::escape_json(s) + "\"";
+        }
+
+        // Written via a temporary file, so that tools never read a half-written one.
+        void write() {
+            boost::system::error_code error;
+            fs::create_directories(file_path.parent_path(), error);
+            const fs::path temp = fs::path(file_path.string() + ".tmp");
+            {
+                std::ofstream ofs(temp.string());
+                ofs << "[";
+                bool first = true;
+                for (const auto& [file, e] : entries) {
+                    ofs << (first ? "\n" : ",\n")
+                        << "  {\n"
+                        << "    \"directory\": " << quote(e.directory) << ",\n"
+                        << "    \"file\": " << quote(e.file) << ",\n"
+                        << "    \"output\": " << quote(e.output) << ",\n"
+                        << "    \"arguments\": [";
+                    for (std::size_t i = 0; i < e.arguments.size(); ++i) {
+                        ofs << (i == 0 ? "" : ", ") << quote(e.arguments[i]);
+                    }
+                    ofs << "]\n"
+                        << "  }";
+                    first = false;
+                }
+                ofs << "\n]\n";
+            }
+            fs::rename(temp, file_path, error);
+        }
+    };
+
+    database& open(const fs::path& p) {
+        return utils::registry::open<database>(p);
+    }
+} // end namespace
+#endif // STROITE_CORE_COMPILE_COMMANDS_HPP
@@ -2,123 +2,342 @@
 #define STROITE_CORE_COMPILER_HPP
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <optional>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 
 #include <boost/filesystem.hpp>
 
-#include "../../command.hpp"
+#include "./depends.hpp"
+#include "./object_cache.hpp"
+#include "./scheduler.hpp"
+#include "./trace.hpp"
+#include "../utils/hash.hpp"
+#include "../utils/options.hpp"
+#include "../../process.hpp"
 
 
 namespace stroite::core::compiler {
     namespace fs = boost::filesystem;
 
+    template <typename Opts>
+    std::string
+    to_obj_path(const Opts& opts, const std::string& source_file)
+    {
+        return (opts.output_root / fs::relative(source_file)).replace_extension("o").string();
+    }
+
+    // -gsplit-dwarf writes the debug info of a translation unit into a .dwo next to its object,
+    //  which is an output of the compilation as well as the object.
+    template <typename Opts>
+    bool
+    is_split_dwarf(const Opts& opts)
+    {
+        return std::find(opts.other_args.begin(), opts.other_args.end(), "-gsplit-dwarf") != opts.other_args.end();
+    }
+    template <typename Opts>
+    std::string
+    to_dwo_path(const Opts& opts, const std::string& source_file)
+    {
+        return fs::path(to_obj_path(opts, source_file)).replace_extension("dwo").string();
+    }
+
+    template <typename Opts>
+    std::vector<std::string>
+    make_compile_args(const Opts& opts, const std::vector<std::string>& flags, const std::vector<std::string>& args)
+    {
+        std::vector<std::string> argv = utils::options::to_args(opts.system);
+        argv.insert(argv.end(), flags.begin(), flags.end());
+        argv.insert(argv.end(), args.begin(), args.end());
+        return argv;
+    }
+
+    // Files of profile data (PGO) which a translation unit is compiled with. (see pgo.hpp)
+    template <typename Opts>
+    std::vector<std::string>
+    to_profile_data_paths(const Opts& opts, const std::string& source_file)
+    {
+        if (!opts.profile_use) {
+            return {};
+        }
+        if (!opts.profile_data.empty()) {
+            return { opts.profile_data };
+        }
+        return { fs::path(to_obj_path(opts, source_file)).replace_extension("gcda").string() };
+    }
+
+    // The command line to compile a translation unit.
+    template <typename Opts>
+    std::vector<std::string>
+    make_tu_args(const Opts& opts, const std::vector<std::string>& flags, const std::string& source_file)
+    {
+        const auto dep_flags = depends::make_flags(opts, source_file);
+        auto args = std::vector<std::string>{ "-c", source_file, "-o", to_obj_path(opts, source_file) };
+        args.insert(args.end(), dep_flags.begin(), dep_flags.end());
+        return make_compile_args(opts, flags, args);
+    }
+
+    // Run a tool, and print what it says at once.
+    // It is traced as `category` (see trace.hpp) with the name of `output`.
+    bool run(
+            const std::vector<std::string>& argv,
+            const bool verbose,
+            const std::string& category,
+            const std::string& output,
+            const std::optional<fs::path>& cwd = std::nullopt)
+    {
+        namespace process = poac::util::process;
+        if (verbose)
+            scheduler::print(process::to_string(argv) + "\n");
+
+        scheduler::token t;
+        trace::span span(fs::path(output).filename().string(), category);
+        const auto result = process::run(argv, { cwd, true });
+        if (!result.out.empty())
+            scheduler::print(result.out);
+        return result.success();
+    }
+
+    // One job per translation unit, run in parallel by the scheduler.
+    // Each job consults the object cache before invoking the compiler.
+    // durations[i] is the time to compile opts.source_files[i] (negative if it came from the cache).
     template <typename Opts>
     std::optional<std::vector<std::string>>
-    compile(const Opts& opts)
+    compile(const Opts& opts, std::vector<double>& durations)
     {
-        poac::util::command cmd("cd " + opts.base_dir.string());
-        cmd &= opts.system;
-        cmd += opts.version_prefix + std::to_string(opts.cpp_version);
-        cmd += "-c";
-        for (const auto& s : opts.source_files)
-            cmd += s;
-        for (const auto& isp : opts.include_search_path)
-            cmd += "-I" + isp;
-        for (const auto& oa : opts.other_args)
-            cmd += oa;
-        for (const auto& md : opts.macro_defns)
-            cmd += md;
-        cmd += "-o";
+        namespace process = poac::util::process;
+
+        const auto flags = utils::options::to_args(opts);
+        const std::string flags_str = process::to_string(flags);
+        const std::string pch_digest = opts.pch_digest.empty() ? "" : ' ' + opts.pch_digest;
+        const bool use_cache = object_cache::enabled();
+        const std::string identity = use_cache ? object_cache::compiler_identity(opts.system) : "";
+
+        std::atomic<std::uint64_t> hits{ 0 };
+        std::atomic<std::uint64_t> misses{ 0 };
+        std::atomic<std::uintmax_t> stored{ 0 };
         std::vector<std::string> obj_files_path;
-        for (const auto& s : opts.source_files) {
-            auto obj_path = opts.output_root / fs::relative(s);
-            obj_path.replace_extension("o");
-            fs::create_directories(obj_path.parent_path());
-            const auto obj_path_str = obj_path.string();
-            obj_files_path.push_back(obj_path_str);
-            cmd += obj_path_str;
-        }
+        std::vector<scheduler::task> tasks;
+        durations.assign(opts.source_files.size(), -1.0);
+        for (std::size_t i = 0; i < opts.source_files.size(); ++i) {
+            const auto& s = opts.source_files[i];
+            const std::string obj_path = to_obj_path(opts, s);
+            fs::create_directories(fs::path(obj_path).parent_path());
+            obj_files_path.push_back(obj_path);
+
+            const auto argv = make_tu_args(opts, flags, s);
+
+            // The dependency file is also written by the preprocessor, or restored from the manifest,
+            //  so it is up to date even if the object comes from the cache.
+            const std::string preprocessed = fs::path(obj_path).replace_extension("ii").string();
+            const auto dep_flags = depends::make_flags(opts, s);
+            const std::string dep_path = depends::to_dep_path(opts, s);
+            auto args = std::vector<std::string>{ "-E", s, "-o", preprocessed };
+            args.insert(args.end(), dep_flags.begin(), dep_flags.end());
+            const auto preprocess = make_compile_args(opts, flags, args);
+            // On a miss, the preprocessed source is compiled instead of running the preprocessor again.
+            const auto compile_preprocessed = make_compile_args(opts, flags, { "-c", preprocessed, "-o", obj_path });
+            const auto profile_data = to_profile_data_paths(opts, s);
+            const std::string dwo_path = to_dwo_path(opts, s);
+            const bool split_dwarf = is_split_dwarf(opts);
 
-        if (opts.verbose)
-            std::cout << cmd << std::endl;
+            tasks.emplace_back([=, &hits, &misses, &stored, &durations, base_dir=opts.base_dir, verbose=opts.verbose]() {
+                trace::span span(fs::relative(fs::absolute(s, base_dir)).string(), "compile");
+                const auto make_header = [&](const std::vector<std::string>& command) {
+                    return verbose ? "cd " + base_dir.string() + " && " + process::to_string(command) + "\n" : "";
+                };
+                const std::string header = make_header(argv);
+                // A .dwo of the last compilation is stale whether or not this one writes it.
+                boost::system::error_code error;
+                fs::remove(dwo_path, error);
+                std::vector<fs::path> companions;
+                if (split_dwarf) {
+                    companions.push_back(dwo_path);
+                }
+                const auto started = object_cache::now();
+                std::optional<std::string> key;
+                std::string direct_key;
+                std::vector<std::string> included;
+                std::string preprocessor_output;
+                if (use_cache) {
+                    // Objects compiled with other profile data are not reused.
+                    std::string profile_digest;
+                    for (const auto& p : profile_data) {
+                        profile_digest += ' ' + utils::hash::to_hex(utils::hash::file(p).value_or(0));
+                    }
+                    // The object refers to its .dwo by the path.
+                    const std::string dwo_name = split_dwarf ? ' ' + dwo_path : "";
+                    const std::string cache_flags = flags_str + profile_digest + dwo_name + pch_digest;
 
-        if (cmd.exec())
+                    direct_key = object_cache::make_direct_key(identity, cache_flags, base_dir, s);
+                    if (const auto m = object_cache::load_manifest(direct_key); m && object_cache::is_unchanged(*m)) {
+                        if (const auto output = object_cache::lookup(m->key, obj_path, companions)) {
+                            std::ofstream(dep_path) << m->depfile;
+                            ++hits;
+                            return scheduler::output{ true, header + *output };
+                        }
+                    }
+                    key = object_cache::make_key(preprocess, base_dir, preprocessed, identity, cache_flags,
+                                                 included, preprocessor_output);
+                    if (key) {
+                        if (const auto output = object_cache::lookup(*key, obj_path, companions)) {
+                            fs::remove(preprocessed, error);
+                            stored += object_cache::store_manifest(direct_key, *key, included, dep_path, started);
+                            ++hits;
+                            return scheduler::output{ true, header + *output };
+                        }
+                        ++misses;
+                    }
+                }
+                // Without a key, the source is compiled as usual, which also reports why it could not be preprocessed.
+                const auto result = key
+                        ? process::run(compile_preprocessed, { base_dir, true })
+                        : process::run(argv, { base_dir, true });
+                if (key) {
+                    fs::remove(preprocessed, error);
+                }
+                const std::string output = preprocessor_output + result.out;
+                if (result.success()) {
+                    durations[i] = result.usage.wall_time;
+                    if (key) {
+                        stored += object_cache::store(*key, obj_path, output, companions);
+                        stored += object_cache::store_manifest(direct_key, *key, included, dep_path, started);
+                    }
+                }
+                return scheduler::output{ result.success(), make_header(key ? compile_preprocessed : argv) + output };
+            });
+        }
+
+        const bool success = scheduler::run(tasks, opts.jobs);
+        // The cache is scanned only if the running total of its size exceeds the limit.
+        if (use_cache && object_cache::record({ hits, misses, stored }).size > object_cache::max_size()) {
+            object_cache::evict(object_cache::max_size());
+        }
+        if (success)
             return obj_files_path;
         else
             return std::nullopt;
     }
+    template <typename Opts>
+    std::optional<std::vector<std::string>>
+    compile(const Opts& opts)
+    {
+        std::vector<double> durations;
+        return compile(opts, durations);
+    }
+
+    // A precompiled header is used only if it is built with the same flags as translation units.
+    template <typename Opts>
+    bool
+    compile_pch(
+            const Opts& opts,
+            const std::string& header,
+            const std::string& output,
+            const std::string& dep_path)
+    {
+        const auto argv = make_compile_args(opts, utils::options::to_args(opts),
+                { "-x", "c++-header", header, "-o", output, "-MMD", "-MF", dep_path });
+        return run(argv, opts.verbose, "pch", header, opts.base_dir);
+    }
+
+    template <typename Opts>
+    std::string
+    to_bin_path(const Opts& opts)
+    {
+        return (opts.output_root / opts.project_name).string();
+    }
 
     template <typename Opts>
     std::optional<std::string>
     link(const Opts& opts)
     {
-        const std::string bin_path =
-                (opts.output_root / opts.project_name).string();
-
-        poac::util::command cmd(opts.system);
-        for (const auto& o : opts.obj_files_path)
-            cmd += o;
-        for (const auto& lsp : opts.library_search_path)
-            cmd += "-L" + lsp;
-        for (const auto& sll : opts.static_link_libs)
-            cmd += "-l" + sll;
-        for (const auto& lp : opts.library_path)
-            cmd += lp;
-        for (const auto& oa : opts.other_args)
-            cmd += oa;
-        cmd += "-o " + bin_path;
-
-        if (opts.verbose)
-            std::cout << cmd << std::endl;
+        const std::string bin_path = to_bin_path(opts);
+
+        auto argv = utils::options::to_args(opts.system);
+        const auto args = utils::options::to_args(opts);
+        argv.insert(argv.end(), args.begin(), args.end());
 
         fs::create_directories(opts.output_root);
-        if (cmd.exec())
+        if (run(argv, opts.verbose, "link", bin_path))
             return bin_path;
         else
             return std::nullopt;
     }
 
+    template <typename Opts>
+    std::string
+    to_static_lib_path(const Opts& opts)
+    {
+        return (opts.output_root / opts.project_name).string() + ".a";
+    }
+
+    // An archive is always created from scratch, so that it does not keep members of removed sources.
+    // `q` (quick append) is used since `r` replaces a member which has the same basename.
     template <typename Opts>
     std::optional<std::string>
     gen_static_lib(const Opts& opts)
     {
-        poac::util::command cmd("ar rcs");
-        const std::string stlib_path =
-                (opts.output_root / opts.project_name).string() + ".a";
-        cmd += stlib_path;
-        for (const auto& o : opts.obj_files_path)
-            cmd += o;
-
-        if (opts.verbose)
-            std::cout << cmd << std::endl;
+        const std::string stlib_path = to_static_lib_path(opts);
+        std::vector<std::string> argv{ "ar", "qcs", stlib_path };
+        argv.insert(argv.end(), opts.obj_files_path.begin(), opts.obj_files_path.end());
 
         fs::create_directories(opts.output_root);
-        if (cmd.exec())
+        boost::system::error_code error;
+        fs::remove(stlib_path, error);
+        if (run(argv, opts.verbose, "archive", stlib_path))
             return stlib_path;
         else
             return std::nullopt;
     }
 
+    // Replace only `changed` members and delete `removed` members of the existing archive.
+    // Members are identified by their basename, so basenames of objects must be unique.
     template <typename Opts>
     std::optional<std::string>
-    gen_dynamic_lib(const Opts& opts)
+    update_static_lib(
+            const Opts& opts,
+            const std::vector<std::string>& changed,
+            const std::vector<std::string>& removed)
     {
-        poac::util::command cmd(opts.system);
-        cmd += "-dynamiclib"; // -shared // FIXME: macosとlinux
-        for (const auto& o : opts.obj_files_path)
-            cmd += o;
-        cmd += "-o";
-        const std::string dylib_path =
-                (opts.output_root / opts.project_name).string() + ".dylib"; // FIXME: macosとlinux
-        cmd += dylib_path;
+        const std::string stlib_path = to_static_lib_path(opts);
+        if (!removed.empty()) {
+            std::vector<std::string> argv{ "ar", "ds", stlib_path };
+            for (const auto& o : removed)
+                argv.push_back(fs::path(o).filename().string());
+            if (!run(argv, opts.verbose, "archive", stlib_path))
+                return std::nullopt;
+        }
+        if (!changed.empty()) {
+            std::vector<std::string> argv{ "ar", "rs", stlib_path };
+            argv.insert(argv.end(), changed.begin(), changed.end());
+            if (!run(argv, opts.verbose, "archive", stlib_path))
+                return std::nullopt;
+        }
+        return stlib_path;
+    }
 
-        if (opts.verbose)
-            std::cout << cmd << std::endl;
+    template <typename Opts>
+    std::string
+    to_dynamic_lib_path(const Opts& opts)
+    {
+        return (opts.output_root / opts.project_name).string() + utils::options::dynamic_lib_extension;
+    }
+
+    template <typename Opts>
+    std::optional<std::string>
+    gen_dynamic_lib(const Opts& opts)
+    {
+        auto argv = utils::options::to_args(opts.system);
+        const auto args = utils::options::to_args(opts);
+        argv.insert(argv.end(), args.begin(), args.end());
+        const std::string dylib_path = to_dynamic_lib_path(opts);
 
         fs::create_directories(opts.output_root);
-        if (cmd.exec())
+        if (run(argv, opts.verbose, "shared", dylib_path))
             return dylib_path;
         else
             return std::nullopt;
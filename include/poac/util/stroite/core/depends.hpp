@@ -5,48 +5,67 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
 
 #include "../utils.hpp"
-#include "../../command.hpp"
+#include "../../../io/file/path.hpp"
 
 
 namespace stroite::core::depends {
+    namespace fs = boost::filesystem;
+
+    // Dependency files are emitted by the compiler as a side effect of compilation (-MMD -MF),
+    //  so that checking whether a source is up to date never runs the preprocessor.
     template <typename Opts>
-    std::optional<std::string>
-    calc(const Opts& opts, const std::string& src_cpp)
+    std::string
+    to_dep_path(const Opts& opts, const std::string& src_cpp)
     {
-        poac::util::command cmd(opts.system);
-        cmd += opts.version_prefix + std::to_string(opts.cpp_version);
-        for (const auto& isp : opts.include_search_path)
-            cmd += "-I" + isp;
-        for (const auto& cta : opts.other_args) // TODO: other_argとして，include search pathを指定する可能性がある．
-            cmd += cta;
-        // Like -M but do not mention header files that are found in system header directories,
-        //  nor header files that are included, directly or indirectly, from such a header.
-        // This implies that the choice of angle brackets or double quotes in an ‘#include’ directive
-        //  does not in itself determine whether that header appears in -MM dependency output.
-        // (https://gcc.gnu.org/onlinedocs/gcc/Preprocessor-Options.html#Preprocessor-Options)
-        cmd += "-MM " + src_cpp;
-
-        if (opts.verbose)
-            std::cout << cmd << std::endl;
-
-        return cmd.exec();
+        return (opts.output_root / fs::relative(src_cpp)).replace_extension("d").string();
     }
 
+    // -MMD: Like -MD except mention only user header files, not system header files.
+    // -MD is equivalent to -M -MF file, except that -E is not implied.
+    // (https://gcc.gnu.org/onlinedocs/gcc/Preprocessor-Options.html#Preprocessor-Options)
     template <typename Opts>
+    std::vector<std::string>
+    make_flags(const Opts& opts, const std::string& src_cpp)
+    {
+        return { "-MMD", "-MF", to_dep_path(opts, src_cpp) };
+    }
+
+    // Headers listed in a dependency file (`target: source headers...`) written by the last successful compilation.
+    // std::nullopt means that it has never been compiled.
+    // The compiler runs in base_dir, so relative paths are resolved from it.
     std::optional<std::vector<std::string>>
-    gen(const Opts& opts, const std::string& src_cpp)
+    read(const fs::path& dep_path, const fs::path& base_dir)
     {
-        if (const auto ret = calc(opts, src_cpp)) {
+        if (const auto ret = poac::io::file::path::read_file(dep_path)) {
             auto deps_headers = utils::misc::split(*ret, " \n\\");
+            deps_headers.erase(std::remove(deps_headers.begin(), deps_headers.end(), ""), deps_headers.end()); // trailing \n
+            if (deps_headers.size() < 2) {
+                return std::nullopt;
+            }
             deps_headers.erase(deps_headers.begin()); // main.o:
             deps_headers.erase(deps_headers.begin()); // main.cpp
+            for (auto& h : deps_headers) {
+                if (fs::path(h).is_relative()) {
+                    h = (base_dir / h).string();
+                }
+            }
             return deps_headers;
         }
         else {
             return std::nullopt;
         }
     }
+
+    template <typename Opts>
+    std::optional<std::vector<std::string>>
+    gen(const Opts& opts, const std::string& src_cpp)
+    {
+        return read(to_dep_path(opts, src_cpp), opts.base_dir);
+    }
 } // end namespace
 #endif // STROITE_CORE_DEPENDS_HPP
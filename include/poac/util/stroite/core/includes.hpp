@@ -0,0 +1,96 @@
+// Cost of headers, computed from the build state
+#ifndef STROITE_CORE_INCLUDES_HPP
+#define STROITE_CORE_INCLUDES_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdint>
+
+#include <boost/filesystem.hpp>
+
+#include "./state.hpp"
+
+
+// Fingerprints of a translation unit list every header in its dependency file
+//  (i.e. included transitively) with the size, so the fan-in of headers is known
+//  after a build without running the preprocessor again.
+namespace stroite::core::includes {
+    namespace fs = boost::filesystem;
+
+    const std::string time_key = "<time>";
+
+    struct header_cost {
+        std::string path;
+        std::uint64_t size = 0;
+        std::size_t fan_in = 0; // Translation units which include it
+        std::uint64_t total_size = 0; // size * fan_in
+        // Compile time of the translation units, divided in proportion to the size of their sources.
+        double estimated_time = 0.0;
+    };
+
+    bool is_source(const std::string& target) {
+        const auto extension = fs::path(target).extension().string();
+        return extension == ".cpp" || extension == ".cxx" || extension == ".cc" || extension == ".cp";
+    }
+    // Fingerprints of PGO builds also have the profile data.
+    bool is_profile_data(const std::string& path) {
+        const auto extension = fs::path(path).extension().string();
+        return extension == ".gcda" || extension == ".profdata";
+    }
+
+    // Sorted by the estimated time, or by the total size if no compile time is recorded.
+    std::vector<header_cost> analyze(state::database& db) {
+        const auto entries = db.all();
+        std::map<std::string, header_cost> costs;
+        bool timed = false;
+        for (const auto& [target, fps] : entries) {
+            if (!is_source(target) || target.rfind('<', 0) == 0) {
+                continue;
+            }
+            std::uint64_t tu_size = 0;
+            for (const auto& [path, fp] : fps) {
+                if (path.rfind('<', 0) != 0 && !is_profile_data(path)) {
+                    tu_size += fp.size;
+                }
+            }
+            double time = 0.0;
+            if (const auto itr = entries.find(time_key + target); itr != entries.end()) {
+                if (const auto t = itr->second.find(time_key); t != itr->second.end()) {
+                    time = static_cast<double>(t->second.size) / 1e6;
+                    timed = true;
+                }
+            }
+            for (const auto& [path, fp] : fps) {
+                // The source itself (targets are relative to the project root)
+                if (path.rfind('<', 0) == 0 || fs::relative(path).string() == target || is_profile_data(path)) {
+                    continue;
+                }
+                // The same header may be written differently (e.g. src/../include/a.hpp).
+                const std::string normalized = fs::path(path).lexically_normal().string();
+                auto& c = costs[normalized];
+                c.path = normalized;
+                c.size = fp.size;
+                ++c.fan_in;
+                c.total_size += fp.size;
+                if (tu_size != 0) {
+                    c.estimated_time += time * static_cast<double>(fp.size) / static_cast<double>(tu_size);
+                }
+            }
+        }
+
+        std::vector<header_cost> result;
+        for (auto& [path, c] : costs) {
+            result.push_back(std::move(c));
+        }
+        std::sort(result.begin(), result.end(), [timed](const auto& l, const auto& r) {
+            if (timed && l.estimated_time != r.estimated_time) {
+                return l.estimated_time > r.estimated_time;
+            }
+            return l.total_size != r.total_size ? l.total_size > r.total_size : l.path < r.path;
+        });
+        return result;
+    }
+} // end namespace
+#endif // STROITE_CORE_INCLUDES_HPP
@@ -0,0 +1,77 @@
+// Per-run memoization of file fingerprints
+#ifndef STROITE_CORE_MEMO_HPP
+#define STROITE_CORE_MEMO_HPP
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <optional>
+#include <cstdint>
+
+#include <sys/stat.h>
+
+#include "./state.hpp"
+#include "../utils/hash.hpp"
+
+
+namespace stroite::core::memo {
+    struct statistics {
+        std::size_t lookups = 0;
+        std::size_t hits = 0; // Found in the table (neither stat'ed nor hashed)
+        std::size_t stats = 0; // stat'ed, and the previous hash was reused
+        std::size_t hashed = 0; // stat'ed and hashed
+    };
+
+    // A header included by many translation units is stat'ed (and hashed) only once per run.
+    class fingerprint_table {
+    public:
+        // `previous` is the fingerprint recorded in the last build.
+        // If mtime and size are the same as it, the file is not read.
+        state::fingerprint
+        get(const std::string& path, const std::optional<state::fingerprint>& previous) {
+            namespace hash = utils::hash;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                ++stat.lookups;
+                if (const auto itr = table.find(path); itr != table.end()) {
+                    ++stat.hits;
+                    return itr->second;
+                }
+            }
+
+            state::fingerprint fp{};
+            if (struct stat st{}; ::stat(path.c_str(), &st) == 0) {
+                // In nanoseconds, since a file is often rewritten within the same second (e.g. objects).
+#ifdef __APPLE__
+                fp.mtime = static_cast<std::int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+                fp.mtime = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+                fp.size = static_cast<std::uint64_t>(st.st_size);
+            }
+            const bool reusable = previous && previous->mtime == fp.mtime && previous->size == fp.size;
+            // A file which can not be read never matches the previous hash.
+            fp.hash = reusable ? previous->hash : hash::file(path).value_or(0);
+
+            std::lock_guard<std::mutex> lock(mtx);
+            ++(reusable ? stat.stats : stat.hashed);
+            return table.emplace(path, fp).first->second;
+        }
+
+        statistics statistic() {
+            std::lock_guard<std::mutex> lock(mtx);
+            return stat;
+        }
+
+    private:
+        std::mutex mtx;
+        std::unordered_map<std::string, state::fingerprint> table;
+        statistics stat;
+    };
+
+    fingerprint_table& fingerprints() {
+        static fingerprint_table table;
+        return table;
+    }
+} // end namespace
+#endif // STROITE_CORE_MEMO_HPP
@@ -0,0 +1,460 @@
+// Content-addressed cache of compiled objects shared by all projects
+#ifndef STROITE_CORE_OBJECT_CACHE_HPP
+#define STROITE_CORE_OBJECT_CACHE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <optional>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+
+#include <boost/filesystem.hpp>
+
+#include "./memo.hpp"
+#include "./state.hpp"
+#include "./toolchain.hpp"
+#include "../utils/hash.hpp"
+#include "../utils/options.hpp"
+#include "../../process.hpp"
+#include "../../../io/file/path.hpp"
+
+
+// Like ccache, an object is looked up in two ways:
+//  direct mode       : hash(compiler identity, flags, source path) -> manifest,
+//                      which is a hit if the files included by the last compilation are unchanged.
+//  preprocessor mode : hash(compiler identity, flags, preprocessed source), if the manifest misses.
+//
+// <poac_object_cache_dir>/ab/abcdef0123456789.o        : object file
+// <poac_object_cache_dir>/ab/abcdef0123456789.log      : compiler output (only if not empty)
+// <poac_object_cache_dir>/ab/abcdef0123456789.dwo      : other outputs, by their extension (e.g. -gsplit-dwarf)
+// <poac_object_cache_dir>/cd/cdef0123456789ab.manifest : key of the object, included files and the dependency file
+// <poac_object_cache_dir>/stats                        : hits, misses and the total size of the entries
+namespace stroite::core::object_cache {
+    namespace fs = boost::filesystem;
+
+    // 5 GiB. Overridden by POAC_OBJECT_CACHE_SIZE (in bytes), and 0 disables the cache.
+    constexpr std::uintmax_t default_max_size = 5ULL * 1024 * 1024 * 1024;
+    // Eviction removes the least recently used entries until the cache fits in this ratio of max_size.
+    constexpr double eviction_ratio = 0.9;
+
+    struct statistics {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        // A running total updated by each store, so that the cache is scanned only when it exceeds max_size.
+        std::uintmax_t size = 0;
+    };
+    struct usage {
+        std::uint64_t objects = 0;
+        std::uintmax_t size = 0;
+    };
+
+    fs::path root() {
+        return poac::io::file::path::poac_object_cache_dir;
+    }
+
+    std::uintmax_t max_size() {
+        if (const char* size = std::getenv("POAC_OBJECT_CACHE_SIZE")) {
+            try {
+                return std::stoull(size);
+            }
+            catch (...) {
+                // fall back to the default
+            }
+        }
+        return default_max_size;
+    }
+
+    bool enabled() {
+        return max_size() != 0;
+    }
+
+    // The compiler is identified by its version string,
+    //  so that upgrading it never reuses objects of the old one.
+    std::string compiler_identity(const std::string& system) {
+        return system + '\n' + toolchain::get(system).identity();
+    }
+
+    namespace detail {
+        // `"path" ...` -> path
+        std::optional<std::string> read_quoted(const std::string_view s) {
+            if (s.empty() || s.front() != '"') {
+                return std::nullopt;
+            }
+            std::string ret;
+            for (std::size_t i = 1; i < s.size(); ++i) {
+                if (s[i] == '"') {
+                    return ret;
+                }
+                if (s[i] == '\\' && i + 1 < s.size()) {
+                    ++i;
+                }
+                ret += s[i];
+            }
+            return std::nullopt;
+        }
+    }
+
+    // Files which a preprocessed source consists of, from its linemarkers (`# 1 "path" flags...`).
+    // A precompiled header is not expanded by -fpch-preprocess, so that its headers are not listed.
+    std::vector<std::string>
+    included_files(const std::string& preprocessed, const fs::path& cwd) {
+        std::set<std::string> files;
+        for (std::size_t pos = 0; pos < preprocessed.size();) {
+            const std::size_t end = std::min(preprocessed.find('\n', pos), preprocessed.size());
+            const std::string_view line(preprocessed.data() + pos, end - pos);
+            pos = end + 1;
+            if (line.empty() || line.front() != '#') {
+                continue;
+            }
+            if (const auto quote = line.find_first_not_of("# 0123456789"); quote != std::string_view::npos) {
+                const auto path = detail::read_quoted(line.substr(quote));
+                // <built-in>, <command-line>
+                if (path && !path->empty() && path->front() != '<') {
+                    files.insert(fs::absolute(*path, cwd).string());
+                }
+            }
+        }
+        return { files.begin(), files.end() };
+    }
+
+    // `preprocess` writes the preprocessed source to `preprocessed`, which is kept to be compiled on a miss.
+    // `output` is what the preprocessor says (e.g. #warning), since compiling the preprocessed source does not repeat it.
+    // `flags` have to identify the precompiled header if any, since it is not expanded.
+    std::optional<std::string>
+    make_key(const std::vector<std::string>& preprocess, const fs::path& cwd, const fs::path& preprocessed,
+             const std::string& identity, const std::string& flags,
+             std::vector<std::string>& included, std::string& output)
+    {
+        namespace hash = utils::hash;
+
+        const auto result = poac::util::process::run(preprocess, { cwd, true });
+        const auto content = result.success() ? poac::io::file::path::read_file(preprocessed) : std::nullopt;
+        if (!content) {
+            boost::system::error_code error;
+            fs::remove(preprocessed, error);
+            return std::nullopt;
+        }
+        included = included_files(*content, cwd);
+        output = result.out;
+        return hash::to_hex(hash::string(identity + '\0' + flags + '\0' + *content));
+    }
+
+    std::string
+    make_direct_key(const std::string& identity, const std::string& flags, const fs::path& cwd, const std::string& source)
+    {
+        namespace hash = utils::hash;
+        return hash::to_hex(hash::string(identity + '\0' + flags + '\0' + fs::absolute(source, cwd).string()));
+    }
+
+    fs::path to_entry_path(const std::string& key, const std::string& extension) {
+        return root() / key.substr(0, 2) / (key + extension);
+    }
+
+    // Returns the compiler output cached with the object.
+    // `companions` are the other outputs, which are restored together.
+    std::optional<std::string>
+    lookup(const std::string& key, const fs::path& obj_path, const std::vector<fs::path>& companions = {}) {
+        const fs::path entry = to_entry_path(key, ".o");
+        boost::system::error_code error;
+        // Nothing in the build tree is touched unless the entry is complete.
+        if (!fs::exists(entry, error)) {
+            return std::nullopt;
+        }
+        fs::copy_file(entry, obj_path, fs::copy_option::overwrite_if_exists, error);
+        if (error) {
+            return std::nullopt;
+        }
+        for (const auto& c : companions) {
+            fs::copy_file(to_entry_path(key, c.extension().string()), c, fs::copy_option::overwrite_if_exists, error);
+            if (error) {
+                return std::nullopt;
+            }
+        }
+        // The modification time is used as the last access time for LRU eviction.
+        fs::last_write_time(entry, std::time(nullptr), error);
+        return poac::io::file::path::read_file(to_entry_path(key, ".log")).value_or("");
+    }
+
+    // An entry is published by rename, so that concurrent builds never see a half-written object.
+    // The object is published last, since a lookup regards an entry without it as absent.
+    // Returns the size of the published file, or std::nullopt.
+    std::optional<std::uintmax_t>
+    publish(const fs::path& file, const fs::path& entry) {
+        boost::system::error_code error;
+        const fs::path temp = entry.parent_path() / fs::unique_path("%%%%-%%%%-%%%%.tmp");
+        fs::copy_file(file, temp, error);
+        if (error) {
+            return std::nullopt;
+        }
+        const auto size = fs::file_size(temp, error);
+        fs::rename(temp, entry, error);
+        if (error) {
+            fs::remove(temp, error);
+            return std::nullopt;
+        }
+        return size;
+    }
+    // Returns the size of the stored files.
+    std::uintmax_t
+    store(const std::string& key, const fs::path& obj_path, const std::string& output,
+          const std::vector<fs::path>& companions = {}) {
+        const fs::path entry = to_entry_path(key, ".o");
+        boost::system::error_code error;
+        fs::create_directories(entry.parent_path(), error);
+        std::uintmax_t total = 0;
+        if (!output.empty()) {
+            std::ofstream(to_entry_path(key, ".log").string()) << output;
+            total += output.size();
+        }
+        for (const auto& c : companions) {
+            const auto size = publish(c, to_entry_path(key, c.extension().string()));
+            if (!size) {
+                return total;
+            }
+            total += *size;
+        }
+        return total + publish(obj_path, entry).value_or(0);
+    }
+
+    struct manifest {
+        std::string key; // of the object
+        state::fingerprints files;
+        std::string depfile;
+    };
+
+    std::optional<manifest> load_manifest(const std::string& direct_key) {
+        const fs::path entry = to_entry_path(direct_key, ".manifest");
+        const auto content = poac::io::file::path::read_file(entry);
+        if (!content) {
+            return std::nullopt;
+        }
+        // <key>
+        // <hash> <mtime> <size> <path> ...
+        // (empty line)
+        // <dependency file>
+        std::istringstream iss(*content);
+        manifest m;
+        if (!std::getline(iss, m.key) || m.key.empty()) {
+            return std::nullopt;
+        }
+        for (std::string line; std::getline(iss, line) && !line.empty(); ) {
+            std::istringstream fields(line);
+            state::fingerprint fp{};
+            std::string path;
+            if (!(fields >> std::hex >> fp.hash >> std::dec >> fp.mtime >> fp.size) || !fields.ignore(1)
+                || !std::getline(fields, path)) {
+                return std::nullopt;
+            }
+            m.files.emplace(path, fp);
+        }
+        m.depfile.assign(std::istreambuf_iterator<char>(iss), std::istreambuf_iterator<char>());
+        boost::system::error_code error;
+        fs::last_write_time(entry, std::time(nullptr), error);
+        return m;
+    }
+
+    // Each file is stat'ed, and hashed only if its mtime or size differs. (see memo.hpp)
+    bool is_unchanged(const manifest& m) {
+        for (const auto& [path, fp] : m.files) {
+            if (memo::fingerprints().get(path, fp).hash != fp.hash) {
+                return false;
+            }
+        }
+        return !m.files.empty();
+    }
+
+    // The object differs on each compilation if a file expands the time, so it is never looked up directly.
+    bool expands_time(const std::string& path) {
+        static std::mutex mtx;
+        static std::unordered_map<std::string, bool> table;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (const auto itr = table.find(path); itr != table.end()) {
+                return itr->second;
+            }
+        }
+        const std::string content = poac::io::file::path::read_file(path).value_or("");
+        const bool ret = content.find("__DATE__") != std::string::npos
+                || content.find("__TIME__") != std::string::npos
+                || content.find("__TIMESTAMP__") != std::string::npos;
+        std::lock_guard<std::mutex> lock(mtx);
+        return table.emplace(path, ret).first->second;
+    }
+
+    // In nanoseconds, like the mtime of fingerprints.
+    std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Records the files `included` by the compilation which started at `started` and made the object of `key`.
+    // A file modified since then may not be the one which was compiled, so that nothing is recorded.
+    // Returns the size of the stored manifest.
+    std::uintmax_t
+    store_manifest(const std::string& direct_key, const std::string& key, const std::vector<std::string>& included,
+                   const fs::path& dep_path, const std::int64_t started)
+    {
+        const auto depfile = poac::io::file::path::read_file(dep_path);
+        if (!depfile) {
+            return 0;
+        }
+        std::ostringstream oss;
+        oss << key << '\n';
+        for (const auto& f : included) {
+            const auto fp = memo::fingerprints().get(f, std::nullopt);
+            if (fp.mtime == 0 || fp.mtime >= started || expands_time(f)) {
+                return 0;
+            }
+            oss << utils::hash::to_hex(fp.hash) << ' ' << fp.mtime << ' ' << fp.size << ' ' << f << '\n';
+        }
+        oss << '\n' << *depfile;
+
+        const fs::path entry = to_entry_path(direct_key, ".manifest");
+        boost::system::error_code error;
+        fs::create_directories(entry.parent_path(), error);
+        const fs::path temp = entry.parent_path() / fs::unique_path("%%%%-%%%%-%%%%.tmp");
+        const std::string content = oss.str();
+        if (!(std::ofstream(temp.string()) << content)) {
+            fs::remove(temp, error);
+            return 0;
+        }
+        fs::rename(temp, entry, error);
+        if (error) {
+            fs::remove(temp, error);
+            return 0;
+        }
+        return content.size();
+    }
+
+    namespace detail {
+        std::mutex& statistics_mutex() {
+            static std::mutex mtx;
+            return mtx;
+        }
+
+        void save_statistics(const statistics& stat) {
+            boost::system::error_code error;
+            fs::create_directories(root(), error);
+            std::ofstream(( root() / "stats" ).string())
+                << "hits " << stat.hits << '\n'
+                << "misses " << stat.misses << '\n'
+                << "size " << stat.size << '\n';
+        }
+    }
+
+    statistics load_statistics() {
+        statistics stat;
+        if (const auto content = poac::io::file::path::read_file(root() / "stats")) {
+            std::istringstream iss(*content);
+            std::string name;
+            std::uint64_t value;
+            while (iss >> name >> value) {
+                if (name == "hits") stat.hits = value;
+                else if (name == "misses") stat.misses = value;
+                else if (name == "size") stat.size = value;
+            }
+        }
+        return stat;
+    }
+
+    // Adds `stat` to the statistics, and returns the new total.
+    statistics record(const statistics& stat) {
+        std::lock_guard<std::mutex> lock(detail::statistics_mutex());
+        statistics total = load_statistics();
+        if (stat.hits == 0 && stat.misses == 0 && stat.size == 0) {
+            return total;
+        }
+        total.hits += stat.hits;
+        total.misses += stat.misses;
+        total.size += stat.size;
+        detail::save_statistics(total);
+        return total;
+    }
+
+    // The files of an entry share the name, and the newest modification time of them is its last access time.
+    struct entry {
+        std::time_t time = 0;
+        std::uintmax_t size = 0;
+        std::vector<fs::path> files;
+        bool object = false;
+    };
+
+    std::map<std::string, entry> entries() {
+        std::map<std::string, entry> ret;
+        boost::system::error_code error;
+        for (fs::recursive_directory_iterator itr(root(), error), end; !error && itr != end; itr.increment(error)) {
+            const fs::path& p = itr->path();
+            // Files in publishing (.tmp) belong to no entry yet.
+            if (itr.level() != 1 || !fs::is_regular_file(p) || p.extension() == ".tmp") {
+                continue;
+            }
+            boost::system::error_code ec;
+            const auto size = fs::file_size(p, ec);
+            const auto time = fs::last_write_time(p, ec);
+            if (ec) {
+                continue;
+            }
+            auto& e = ret[( p.parent_path() / p.stem() ).string()];
+            e.time = std::max(e.time, time);
+            e.size += size;
+            e.files.push_back(p);
+            e.object = e.object || p.extension() == ".o";
+        }
+        return ret;
+    }
+
+    usage calc_usage() {
+        usage u;
+        for (const auto& [name, e] : entries()) {
+            if (e.object) {
+                ++u.objects;
+            }
+            u.size += e.size;
+        }
+        return u;
+    }
+
+    // Evict the least recently used entries if the cache exceeds `limit`.
+    // The running total of the statistics is corrected by the scan,
+    //  since it is not updated when an entry is overwritten or removed by others.
+    void evict(const std::uintmax_t limit) {
+        const auto all = entries();
+        std::vector<const entry*> lru;
+        std::uintmax_t total = 0;
+        for (const auto& [name, e] : all) {
+            lru.push_back(&e);
+            total += e.size;
+        }
+        if (total > limit) {
+            std::stable_sort(lru.begin(), lru.end(), [](const entry* a, const entry* b) { return a->time < b->time; });
+            const auto target = static_cast<std::uintmax_t>(limit * eviction_ratio);
+            boost::system::error_code error;
+            for (const auto e : lru) {
+                if (total <= target) {
+                    break;
+                }
+                for (const auto& f : e->files) {
+                    fs::remove(f, error);
+                }
+                total -= std::min(total, e->size);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(detail::statistics_mutex());
+        statistics stat = load_statistics();
+        stat.size = total;
+        detail::save_statistics(stat);
+    }
+} // end namespace
+#endif // STROITE_CORE_OBJECT_CACHE_HPP
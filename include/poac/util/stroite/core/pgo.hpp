@@ -0,0 +1,148 @@
+// Profile-guided optimization (poac build --pgo)
+#ifndef STROITE_CORE_PGO_HPP
+#define STROITE_CORE_PGO_HPP
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "./compiler.hpp"
+#include "./profile.hpp"
+#include "../../process.hpp"
+#include "../../../core/exception.hpp"
+#include "../../../io/file/path.hpp"
+
+
+// pgo:
+//   args:       # arguments of the training run
+//     - data/train.txt
+//
+// 1. The project is built with -fprofile-generate into the profile <name>-pgo-gen.
+// 2. The instrumented binary is run with pgo: args, and writes profile data.
+// 3. The project is built with -fprofile-use into the profile <name>.
+//
+// GCC writes a .gcda next to each object and reads it next to the object being compiled,
+//  so .gcda files are copied into the same relative paths of the object tree of <name>.
+// clang writes .profraw files, which are merged into one .profdata by llvm-profdata.
+//
+// The profile data of a translation unit is a part of its fingerprints and object cache key,
+//  so only translation units whose profile has changed are compiled again.
+namespace stroite::core::pgo {
+    namespace fs = boost::filesystem;
+
+    std::string to_instrumented_name(const std::string& name) {
+        return name + "-pgo-gen";
+    }
+
+    fs::path to_obj_dir(const std::string& name) {
+        return profile::to_dir(poac::io::file::path::current_build_cache_obj_dir, name);
+    }
+    // Profile data of clang
+    fs::path to_data_dir(const std::string& name) {
+        return profile::to_dir(poac::io::file::path::current_build_cache_dir, name) / "pgo";
+    }
+
+    profile::settings instrumented(const profile::settings& base, const bool is_clang) {
+        auto s = base;
+        s.name = to_instrumented_name(base.name);
+        const std::string flag = is_clang
+                ? "-fprofile-generate=" + fs::absolute(to_data_dir(s.name)).string()
+                : "-fprofile-generate";
+        s.compile_args.push_back(flag);
+        s.link_args.push_back(flag);
+        return s;
+    }
+
+    profile::settings optimized(const profile::settings& base, const bool is_clang) {
+        auto s = base;
+        s.profile_use = true;
+        if (is_clang) {
+            s.profile_data = fs::absolute(to_data_dir(base.name) / "default.profdata").string();
+            s.compile_args.push_back("-fprofile-use=" + s.profile_data);
+            s.compile_args.push_back("-Wno-profile-instr-unprofiled");
+        }
+        else {
+            s.compile_args.insert(s.compile_args.end(), {
+                "-fprofile-use", "-fprofile-correction", "-Wno-missing-profile" });
+        }
+        return s;
+    }
+
+    std::vector<fs::path> find_files(const fs::path& dir, const std::string& extension) {
+        std::vector<fs::path> files;
+        boost::system::error_code error;
+        for (fs::recursive_directory_iterator itr(dir, error), end; !error && itr != end; itr.increment(error)) {
+            if (fs::is_regular_file(itr->path()) && itr->path().extension() == extension) {
+                files.push_back(itr->path());
+            }
+        }
+        return files;
+    }
+
+    // Profile data is accumulated over runs, so the data of the last training is removed first.
+    void clean(const std::string& instrumented_name) {
+        boost::system::error_code error;
+        for (const auto& f : find_files(to_obj_dir(instrumented_name), ".gcda")) {
+            fs::remove(f, error);
+        }
+        fs::remove_all(to_data_dir(instrumented_name), error);
+    }
+
+    void train(const std::vector<std::string>& argv, const bool verbose) {
+        namespace process = poac::util::process;
+        namespace exception = poac::core::exception;
+        if (verbose) {
+            scheduler::print(process::to_string(argv) + "\n");
+        }
+        const auto result = process::run(argv, { std::nullopt, true });
+        scheduler::print(result.out);
+        if (!result.success()) {
+            throw exception::error(
+                    "Training run `" + process::to_string(argv) + "` returned " + std::to_string(result.exit_code));
+        }
+    }
+
+    // Move the profile data of the instrumented build to where the optimized build reads it.
+    void collect(const std::string& name, const bool is_clang, const bool verbose) {
+        namespace exception = poac::core::exception;
+
+        const std::string instrumented_name = to_instrumented_name(name);
+        if (is_clang) {
+            const auto raw = find_files(to_data_dir(instrumented_name), ".profraw");
+            if (raw.empty()) {
+                throw exception::error("The training run wrote no profile data.");
+            }
+            fs::create_directories(to_data_dir(name));
+            const fs::path merged = to_data_dir(name) / "default.profdata";
+            std::vector<std::string> argv{ "llvm-profdata", "merge", "-o", merged.string() };
+            for (const auto& r : raw) {
+                argv.push_back(r.string());
+            }
+            if (!compiler::run(argv, verbose, "pgo", merged.string())) {
+                throw exception::error("Failed to merge profile data with llvm-profdata.");
+            }
+            return;
+        }
+
+        const fs::path from = to_obj_dir(instrumented_name);
+        const fs::path to = to_obj_dir(name);
+        const auto gcda = find_files(from, ".gcda");
+        if (gcda.empty()) {
+            throw exception::error("The training run wrote no profile data.");
+        }
+        // Profiles of sources which were not run in this training are stale.
+        boost::system::error_code error;
+        for (const auto& f : find_files(to, ".gcda")) {
+            if (!fs::exists(from / f.lexically_relative(to))) {
+                fs::remove(f, error);
+            }
+        }
+        for (const auto& f : gcda) {
+            const fs::path dest = to / f.lexically_relative(from);
+            fs::create_directories(dest.parent_path());
+            fs::copy_file(f, dest, fs::copy_option::overwrite_if_exists);
+        }
+    }
+} // end namespace
+#endif // STROITE_CORE_PGO_HPP
@@ -0,0 +1,176 @@
+// Build profiles (--release, --profile <name>)
+#ifndef STROITE_CORE_PROFILE_HPP
+#define STROITE_CORE_PROFILE_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+
+#include <boost/filesystem.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include "../../../core/exception.hpp"
+#include "../../../io/file/path.hpp"
+#include "../../../io/file/yaml.hpp"
+
+
+// profile:
+//   release:            # overrides the built-in one
+//     compile_args:
+//       - -O3
+//     lto: true
+//   asan:               # a custom profile
+//     compile_args:
+//       - -fsanitize=address
+//     link_args:
+//       - -fsanitize=address
+//   relwithdebinfo:
+//     split_dwarf: true              # -gsplit-dwarf: debug info stays in .dwo files, out of the link
+//     gdb_index: true                # the linker writes .gdb_index (needs build: linker: gold, lld or mold)
+//     compress_debug_sections: true  # -gz: zlib-compressed debug sections
+//
+// Every profile except debug has its own tree in _build/<name>, with its own objects and
+//  build state, so switching profiles never invalidates the other one's cache.
+// Hence the names of the other entries of _build (bin, lib, test and _cache) cannot be used.
+// The profile of the project is also applied to all of its dependencies.
+namespace stroite::core::profile {
+    namespace fs = boost::filesystem;
+
+    const std::string default_name = "debug";
+
+    struct settings {
+        std::string name = default_name;
+        std::vector<std::string> compile_args;
+        std::vector<std::string> link_args;
+        bool lto = false;
+        bool split_dwarf = false;
+        bool gdb_index = false;
+        bool compress_debug_sections = false;
+        // Compiled with profile data of PGO (see pgo.hpp)
+        bool profile_use = false;
+        std::string profile_data;
+    };
+
+    // debug adds nothing to build: compile_args, as the build without a profile did.
+    std::optional<settings> builtin(const std::string& name) {
+        settings s;
+        s.name = name;
+        if (name == "debug") {
+            return s;
+        }
+        else if (name == "release") {
+            s.compile_args = { "-O2", "-DNDEBUG" };
+            return s;
+        }
+        else if (name == "relwithdebinfo") {
+            s.compile_args = { "-O2", "-g", "-DNDEBUG" };
+            return s;
+        }
+        return std::nullopt;
+    }
+
+    settings resolve(const YAML::Node& config, const std::string& name) {
+        namespace yaml = poac::io::file::yaml;
+        namespace exception = poac::core::exception;
+
+        if (name.empty() || name.find_first_of("/\\.") != std::string::npos) {
+            throw exception::error("Invalid profile name: `" + name + "`");
+        }
+        // A profile is built in _build/<name>, which would be mixed with the debug tree.
+        for (const auto& child : poac::io::file::path::current_build_children) {
+            if (child.filename() == name) {
+                throw exception::error("Profile name `" + name + "` is reserved by the build directory");
+            }
+        }
+        std::optional<YAML::Node> defined;
+        if (const auto profiles = yaml::get<std::map<std::string, YAML::Node>>(config, "profile")) {
+            if (const auto itr = profiles->find(name); itr != profiles->end()) {
+                defined = itr->second;
+            }
+        }
+
+        auto s = builtin(name);
+        if (!s && !defined) {
+            throw exception::error(
+                    "Profile `" + name + "` is not defined.\n"
+                    "Define it in the `profile` key of poac.yml.");
+        }
+        if (!s) {
+            s = settings{};
+            s->name = name;
+        }
+        if (defined) {
+            if (const auto args = yaml::get<std::vector<std::string>>(*defined, "compile_args")) {
+                s->compile_args = *args;
+            }
+            if (const auto args = yaml::get<std::vector<std::string>>(*defined, "link_args")) {
+                s->link_args = *args;
+            }
+            if (const auto lto = yaml::get<bool>(*defined, "lto")) {
+                s->lto = *lto;
+            }
+            if (const auto split_dwarf = yaml::get<bool>(*defined, "split_dwarf")) {
+                s->split_dwarf = *split_dwarf;
+            }
+            if (const auto gdb_index = yaml::get<bool>(*defined, "gdb_index")) {
+                s->gdb_index = *gdb_index;
+            }
+            if (const auto compress = yaml::get<bool>(*defined, "compress_debug_sections")) {
+                s->compress_debug_sections = *compress;
+            }
+        }
+        return *s;
+    }
+
+    // _build/_cache/obj -> _build/<name>/_cache/obj
+    fs::path to_dir(const fs::path& p, const std::string& name) {
+        namespace path = poac::io::file::path;
+        if (name == default_name) {
+            return p;
+        }
+        return path::current_build_dir / name / p.lexically_relative(path::current_build_dir);
+    }
+
+    // Objects carry the intermediate representation, and code generation is done at link time.
+    // GCC runs LTRANS in `jobs` parallel processes, and clang uses ThinLTO, which is parallel by itself.
+    std::vector<std::string> lto_compile_args(const bool is_clang) {
+        return { is_clang ? "-flto=thin" : "-flto" };
+    }
+    std::vector<std::string> lto_link_args(const bool is_clang, const unsigned int jobs) {
+        if (is_clang) {
+            return { "-flto=thin" };
+        }
+        return { "-flto=" + std::to_string(jobs) };
+    }
+
+    // These imply -g, since they are meaningless without debug info.
+    // The index of gdb is built from .debug_gnu_pubnames, which is emitted by -ggnu-pubnames.
+    std::vector<std::string> debug_compile_args(const settings& s) {
+        std::vector<std::string> args;
+        if (s.split_dwarf) {
+            args.push_back("-gsplit-dwarf");
+        }
+        if (s.gdb_index) {
+            args.push_back("-ggnu-pubnames");
+        }
+        if (s.compress_debug_sections) {
+            args.push_back("-gz");
+        }
+        if (!args.empty()) {
+            args.insert(args.begin(), "-g");
+        }
+        return args;
+    }
+    std::vector<std::string> debug_link_args(const settings& s) {
+        std::vector<std::string> args;
+        if (s.gdb_index) {
+            args.push_back("-Wl,--gdb-index");
+        }
+        if (s.compress_debug_sections) {
+            args.push_back("-gz");
+        }
+        return args;
+    }
+} // end namespace
+#endif // STROITE_CORE_PROFILE_HPP
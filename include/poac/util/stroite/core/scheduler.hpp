@@ -0,0 +1,190 @@
+#ifndef STROITE_CORE_SCHEDULER_HPP
+#define STROITE_CORE_SCHEDULER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <algorithm>
+
+
+namespace stroite::core::scheduler {
+    unsigned int default_jobs() {
+        // hardware_concurrency may return 0 when it is not computable.
+        const unsigned int n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    struct output {
+        bool success;
+        std::string message;
+    };
+    using task = std::function<output()>;
+
+    std::mutex& output_mutex() {
+        static std::mutex m;
+        return m;
+    }
+    // Each job's diagnostics are written at once, so they never interleave.
+    void print(const std::string& s) {
+        std::lock_guard<std::mutex> lock(output_mutex());
+        std::cout << s << std::flush;
+    }
+
+    // Tokens shared by all schedulers in the process.
+    // Even if packages are built concurrently and each of them compiles in parallel,
+    //  no more than `jobs` processes run at the same time (like the jobserver of GNU make).
+    class token_pool {
+    public:
+        void resize(const unsigned int n) {
+            std::lock_guard<std::mutex> lock(mtx);
+            available += static_cast<long>(n) - static_cast<long>(capacity);
+            capacity = n;
+            cv.notify_all();
+        }
+        void acquire() {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]{ return available > 0; });
+            --available;
+        }
+        void release() {
+            std::lock_guard<std::mutex> lock(mtx);
+            ++available;
+            cv.notify_one();
+        }
+
+    private:
+        std::mutex mtx;
+        std::condition_variable cv;
+        unsigned int capacity = default_jobs();
+        long available = capacity;
+    };
+
+    token_pool& tokens() {
+        static token_pool pool;
+        return pool;
+    }
+    void set_jobs(const unsigned int jobs) {
+        tokens().resize(std::max(jobs, 1u));
+    }
+
+    // Held while a process (compiler, linker, archiver) is running.
+    struct token {
+        token() { tokens().acquire(); }
+        ~token() { tokens().release(); }
+        token(const token&) = delete;
+        token& operator=(const token&) = delete;
+    };
+
+    // Run tasks on at most `jobs` workers.
+    // As with make without -k, no new task is started after a failure.
+    bool run(const std::vector<task>& tasks, const unsigned int jobs) {
+        std::atomic<std::size_t> next{ 0 };
+        std::atomic<bool> success{ true };
+
+        const auto worker = [&]() {
+            for (std::size_t i = next++; i < tasks.size() && success; i = next++) {
+                const auto [ok, message] = [&]{ token t; return tasks[i](); }();
+                if (!message.empty()) {
+                    print(message);
+                }
+                if (!ok) {
+                    success = false;
+                }
+            }
+        };
+
+        const std::size_t workers = std::min<std::size_t>(std::max(jobs, 1u), tasks.size());
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < workers; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker(); // The current thread is also used as a worker.
+        for (auto& t : threads) {
+            t.join();
+        }
+        return success;
+    }
+
+    // Run tasks in a topological order, where dependencies[i] is the tasks which tasks[i] depends on.
+    // Tasks which do not depend on each other run concurrently on at most `jobs` workers.
+    // They hold no token themselves, since they are expected to start processes through `run`.
+    // Returns false if a task fails or the graph has a cycle.
+    bool run_graph(
+            const std::vector<task>& tasks,
+            const std::vector<std::vector<std::size_t>>& dependencies,
+            const unsigned int jobs)
+    {
+        std::vector<std::size_t> waiting(tasks.size());
+        std::vector<std::vector<std::size_t>> dependents(tasks.size());
+        std::deque<std::size_t> ready;
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            waiting[i] = dependencies[i].size();
+            for (const auto& d : dependencies[i]) {
+                dependents[d].push_back(i);
+            }
+            if (waiting[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::size_t running = 0;
+        std::size_t finished = 0;
+        bool success = true;
+
+        const auto worker = [&]() {
+            std::unique_lock<std::mutex> lock(mtx);
+            while (true) {
+                cv.wait(lock, [&]{ return !ready.empty() || running == 0; });
+                if (ready.empty() || !success) {
+                    return;
+                }
+                const std::size_t i = ready.front();
+                ready.pop_front();
+                ++running;
+
+                lock.unlock();
+                const auto [ok, message] = tasks[i]();
+                if (!message.empty()) {
+                    print(message);
+                }
+                lock.lock();
+
+                --running;
+                ++finished;
+                if (!ok) {
+                    success = false;
+                }
+                else {
+                    for (const auto& d : dependents[i]) {
+                        if (--waiting[d] == 0) {
+                            ready.push_back(d);
+                        }
+                    }
+                }
+                cv.notify_all();
+            }
+        };
+
+        const std::size_t workers = std::min<std::size_t>(std::max(jobs, 1u), tasks.size());
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < workers; ++i) {
+            threads.emplace_back(worker);
+        }
+        if (workers != 0) {
+            worker();
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        return success && finished == tasks.size();
+    }
+} // end namespace
+#endif // STROITE_CORE_SCHEDULER_HPP
@@ -0,0 +1,302 @@
+// Persistent build state (dependency graph and fingerprints)
+#ifndef STROITE_CORE_STATE_HPP
+#define STROITE_CORE_STATE_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <fstream>
+#include <optional>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+
+#include "../utils/registry.hpp"
+
+
+// All targets are kept in one append-only log file (like .ninja_deps),
+//  so that a no-op build needs one read instead of opening a file per source.
+//
+// header : magic(8) version(u32)
+// record : kind(u32) ...
+//   path  : kind=0 length(u32) bytes(length)
+//           -> The n-th path record defines the path whose id is n.
+//   entry : kind=1 target(u32) count(u32) { path(u32) mtime(i64) size(u64) hash(u64) } * count
+//           -> A later entry of the same target overrides the former.
+namespace stroite::core::state {
+    namespace fs = boost::filesystem;
+
+    struct fingerprint {
+        std::uint64_t hash;
+        std::int64_t mtime;
+        std::uint64_t size;
+    };
+    using fingerprints = std::map<std::string, fingerprint>;
+
+    namespace detail {
+        constexpr char magic[8] = { 'p', 'o', 'a', 'c', 's', 't', 'a', 't' };
+        constexpr std::uint32_t version = 1;
+        constexpr std::size_t header_size = sizeof(magic) + sizeof(version);
+        constexpr std::uint32_t path_record = 0;
+        constexpr std::uint32_t entry_record = 1;
+        // Compaction is done when the log has more than this many entries and
+        //  more than three times as many entries as live targets.
+        constexpr std::size_t min_compaction_entry_count = 1000;
+        constexpr std::size_t compaction_ratio = 3;
+
+        template <typename T>
+        bool read(const char*& p, const char* const end, T& v) {
+            if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return true;
+        }
+        template <typename T>
+        void write(std::string& buf, const T& v) {
+            buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+        }
+
+        // The whole file is read at once through mmap.
+        class mapped_file {
+        public:
+            explicit mapped_file(const fs::path& p) {
+                const int fd = ::open(p.string().c_str(), O_RDONLY);
+                if (fd < 0) {
+                    return;
+                }
+                struct stat st{};
+                if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                    void* const addr = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (addr != MAP_FAILED) {
+                        addr_ = static_cast<const char*>(addr);
+                        size_ = static_cast<std::size_t>(st.st_size);
+                    }
+                }
+                ::close(fd);
+            }
+            ~mapped_file() {
+                if (addr_) {
+                    ::munmap(const_cast<char*>(addr_), size_);
+                }
+            }
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            const char* data() const { return addr_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            const char* addr_ = nullptr;
+            std::size_t size_ = 0;
+        };
+    }
+
+    class database {
+    public:
+        explicit database(const fs::path& p) : file_path(p) {
+            // A half written record which could not be cut off is dropped by rewriting the log.
+            const bool truncated = load();
+            if (!truncated
+                || (entry_count > detail::min_compaction_entry_count
+                    && entry_count > entries.size() * detail::compaction_ratio))
+            {
+                compact();
+            }
+        }
+
+        std::optional<fingerprints>
+        get(const std::string& target) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (const auto itr = entries.find(target); itr != entries.end()) {
+                return itr->second;
+            }
+            return std::nullopt;
+        }
+
+        // Appended to the log immediately, so that what is already built
+        //  is not lost even if the build is interrupted.
+        void put(const std::string& target, const fingerprints& fps) {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (const auto itr = entries.find(target); itr != entries.end() && equal(itr->second, fps)) {
+                return;
+            }
+            std::string buf;
+            const std::uint32_t target_id = intern(target, buf);
+            std::vector<std::uint32_t> ids;
+            for (const auto& [path, fp] : fps) {
+                ids.push_back(intern(path, buf));
+            }
+            detail::write(buf, detail::entry_record);
+            detail::write(buf, target_id);
+            detail::write(buf, static_cast<std::uint32_t>(fps.size()));
+            auto id = ids.begin();
+            for (const auto& [path, fp] : fps) {
+                detail::write(buf, *id++);
+                detail::write(buf, fp.mtime);
+                detail::write(buf, fp.size);
+                detail::write(buf, fp.hash);
+            }
+            append(buf);
+            entries[target] = fps;
+            ++entry_count;
+        }
+
+        std::map<std::string, fingerprints>
+        all() {
+            std::lock_guard<std::mutex> lock(mtx);
+            return entries;
+        }
+
+    private:
+        fs::path file_path;
+        std::mutex mtx;
+        std::map<std::string, fingerprints> entries;
+        std::vector<std::string> paths;
+        std::unordered_map<std::string, std::uint32_t> ids;
+        std::size_t entry_count = 0;
+        std::ofstream ofs;
+
+        static bool equal(const fingerprints& lhs, const fingerprints& rhs) {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                    [](const auto& l, const auto& r) {
+                        return l.first == r.first && l.second.hash == r.second.hash
+                            && l.second.mtime == r.second.mtime && l.second.size == r.second.size;
+                    });
+        }
+
+        std::uint32_t intern(const std::string& path, std::string& buf) {
+            if (const auto itr = ids.find(path); itr != ids.end()) {
+                return itr->second;
+            }
+            const auto id = static_cast<std::uint32_t>(paths.size());
+            paths.push_back(path);
+            ids.emplace(path, id);
+            detail::write(buf, detail::path_record);
+            detail::write(buf, static_cast<std::uint32_t>(path.size()));
+            buf += path;
+            return id;
+        }
+
+        // Returns false if the log has a broken record at the end which could not be cut off.
+        bool load() {
+            const detail::mapped_file content(file_path);
+            if (content.size() < detail::header_size
+                || std::memcmp(content.data(), detail::magic, sizeof(detail::magic)) != 0)
+            {
+                reset();
+                return true;
+            }
+            const char* p = content.data() + sizeof(detail::magic);
+            const char* const end = content.data() + content.size();
+            std::uint32_t ver;
+            if (!detail::read(p, end, ver) || ver != detail::version) {
+                reset();
+                return true;
+            }
+
+            const char* valid = p;
+            std::uint32_t kind;
+            while (detail::read(p, end, kind)) {
+                if (kind == detail::path_record) {
+                    std::uint32_t length;
+                    if (!detail::read(p, end, length) || static_cast<std::size_t>(end - p) < length) {
+                        break;
+                    }
+                    const std::string path(p, length);
+                    p += length;
+                    ids.emplace(path, static_cast<std::uint32_t>(paths.size()));
+                    paths.push_back(path);
+                }
+                else if (kind == detail::entry_record) {
+                    std::uint32_t target, count;
+                    if (!detail::read(p, end, target) || !detail::read(p, end, count) || target >= paths.size()) {
+                        break;
+                    }
+                    fingerprints fps;
+                    bool ok = true;
+                    for (std::uint32_t i = 0; i < count && ok; ++i) {
+                        std::uint32_t id;
+                        fingerprint fp{};
+                        ok = detail::read(p, end, id) && id < paths.size()
+                          && detail::read(p, end, fp.mtime)
+                          && detail::read(p, end, fp.size)
+                          && detail::read(p, end, fp.hash);
+                        if (ok) {
+                            fps.emplace(paths[id], fp);
+                        }
+                    }
+                    if (!ok) {
+                        break;
+                    }
+                    entries[paths[target]] = std::move(fps);
+                    ++entry_count;
+                }
+                else {
+                    break;
+                }
+                valid = p;
+            }
+            // Drop a record which was half written by an interrupted build.
+            if (valid != end) {
+                boost::system::error_code error;
+                fs::resize_file(file_path, static_cast<std::uintmax_t>(valid - content.data()), error);
+                return !error;
+            }
+            return true;
+        }
+
+        void reset() {
+            entries.clear();
+            paths.clear();
+            ids.clear();
+            entry_count = 0;
+
+            boost::system::error_code error;
+            fs::create_directories(file_path.parent_path(), error);
+            std::ofstream out(file_path.string(), std::ios::binary | std::ios::trunc);
+            out.write(detail::magic, sizeof(detail::magic));
+            out.write(reinterpret_cast<const char*>(&detail::version), sizeof(detail::version));
+        }
+
+        void append(const std::string& buf) {
+            if (!ofs.is_open()) {
+                ofs.open(file_path.string(), std::ios::binary | std::ios::app);
+            }
+            ofs.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+            ofs.flush();
+        }
+
+        // Rewrite the log with only live entries.
+        void compact() {
+            const auto live = std::move(entries);
+            const fs::path live_path = file_path;
+            file_path = fs::path(live_path.string() + ".tmp");
+            reset();
+            for (const auto& [target, fps] : live) {
+                put(target, fps);
+            }
+            ofs.close();
+            boost::system::error_code error;
+            fs::rename(file_path, live_path, error);
+            if (error) {
+                fs::remove(file_path, error);
+            }
+            file_path = live_path;
+        }
+    };
+
+    database& open(const fs::path& p) {
+        return utils::registry::open<database>(p);
+    }
+} // end namespace
+#endif // STROITE_CORE_STATE_HPP
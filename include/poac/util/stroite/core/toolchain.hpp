@@ -0,0 +1,235 @@
+// Probed information of a compiler, persisted across runs
+#ifndef STROITE_CORE_TOOLCHAIN_HPP
+#define STROITE_CORE_TOOLCHAIN_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <optional>
+#include <algorithm>
+#include <cstdint>
+
+#include <sys/stat.h>
+
+#include <boost/filesystem.hpp>
+
+#include "../utils/hash.hpp"
+#include "../utils/options.hpp"
+#include "../../process.hpp"
+#include "../../../io/file/path.hpp"
+
+
+// Probing a compiler forks it several times, so the result is stored in
+//  <poac_toolchain_dir>/<hash of the command> and reused while every executable
+//  of the command (e.g. both ccache and g++ of "ccache g++") has the same mtime, inode and size.
+namespace stroite::core::toolchain {
+    namespace fs = boost::filesystem;
+
+    // -std levels which are probed
+    const std::vector<unsigned int> std_levels{ 98, 11, 14, 17, 20, 23 };
+
+    struct stamp {
+        std::string path; // canonical
+        std::int64_t mtime; // nanoseconds
+        std::uint64_t inode;
+        std::uint64_t size;
+    };
+    bool operator==(const stamp& lhs, const stamp& rhs) {
+        return lhs.path == rhs.path && lhs.mtime == rhs.mtime && lhs.inode == rhs.inode && lhs.size == rhs.size;
+    }
+
+    struct probe {
+        std::vector<stamp> stamps;
+        std::string version; // The first line of --version
+        std::string triple; // -dumpmachine
+        std::vector<unsigned int> std_levels; // Supported -std=c++XX
+        bool is_clang = false;
+
+        bool supports(const unsigned int level) const {
+            return std::find(std_levels.begin(), std_levels.end(), level) != std_levels.end();
+        }
+        // Used as a part of object cache keys.
+        std::string identity() const {
+            std::string s = version + '\n' + triple;
+            for (const auto& st : stamps) {
+                s += '\n' + st.path;
+            }
+            return s;
+        }
+    };
+
+    fs::path root() {
+        return poac::io::file::path::poac_toolchain_dir;
+    }
+
+    std::optional<stamp> make_stamp(const std::string& executable) {
+        boost::system::error_code error;
+        const fs::path path = fs::canonical(executable, error);
+        if (error) {
+            return std::nullopt;
+        }
+        struct stat st{};
+        if (::stat(path.c_str(), &st) != 0) {
+            return std::nullopt;
+        }
+#ifdef __APPLE__
+        const auto mtime = static_cast<std::int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+        const auto mtime = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+        return stamp{ path.string(), mtime, static_cast<std::uint64_t>(st.st_ino), static_cast<std::uint64_t>(st.st_size) };
+    }
+
+    // Arguments which are not options are regarded as executables.
+    std::optional<std::vector<stamp>>
+    make_stamps(const std::vector<std::string>& argv) {
+        std::vector<stamp> stamps;
+        for (const auto& a : argv) {
+            if (a.empty() || a[0] == '-') {
+                continue;
+            }
+            const auto executable = poac::util::process::find_executable(a);
+            if (!executable) {
+                return std::nullopt;
+            }
+            if (const auto st = make_stamp(*executable)) {
+                stamps.push_back(*st);
+            }
+            else {
+                return std::nullopt;
+            }
+        }
+        return stamps;
+    }
+
+    fs::path to_entry_path(const std::string& system) {
+        return root() / utils::hash::to_hex(utils::hash::string(system));
+    }
+
+    std::optional<probe> load(const std::string& system) {
+        const auto content = poac::io::file::path::read_file(to_entry_path(system));
+        if (!content) {
+            return std::nullopt;
+        }
+        probe p;
+        std::istringstream iss(*content);
+        for (std::string line; std::getline(iss, line);) {
+            const auto pos = line.find(' ');
+            const std::string name = line.substr(0, pos);
+            std::istringstream value(pos == std::string::npos ? "" : line.substr(pos + 1));
+            if (name == "stamp") {
+                stamp st;
+                if (value >> st.mtime >> st.inode >> st.size && std::getline(value >> std::ws, st.path)) {
+                    p.stamps.push_back(st);
+                }
+            }
+            else if (name == "version") {
+                std::getline(value, p.version);
+            }
+            else if (name == "triple") {
+                value >> p.triple;
+            }
+            else if (name == "std") {
+                for (unsigned int level; value >> level;) {
+                    p.std_levels.push_back(level);
+                }
+            }
+            else if (name == "clang") {
+                value >> p.is_clang;
+            }
+        }
+        return p;
+    }
+
+    // Written via a temporary file, so that concurrent builds never read a half-written entry.
+    void save(const std::string& system, const probe& p) {
+        const fs::path entry = to_entry_path(system);
+        boost::system::error_code error;
+        fs::create_directories(entry.parent_path(), error);
+        const fs::path temp = entry.parent_path() / fs::unique_path("%%%%-%%%%-%%%%.tmp");
+        {
+            std::ofstream ofs(temp.string());
+            for (const auto& st : p.stamps) {
+                ofs << "stamp " << st.mtime << ' ' << st.inode << ' ' << st.size << ' ' << st.path << '\n';
+            }
+            ofs << "version " << p.version << '\n'
+                << "triple " << p.triple << '\n'
+                << "std";
+            for (const auto level : p.std_levels) {
+                ofs << ' ' << level;
+            }
+            ofs << '\n'
+                << "clang " << p.is_clang << '\n';
+        }
+        fs::rename(temp, entry, error);
+        if (error) {
+            fs::remove(temp, error);
+        }
+    }
+
+    // Fork the compiler to probe it. -std levels are probed in parallel.
+    probe run_probe(const std::vector<std::string>& argv, std::vector<stamp> stamps) {
+        namespace process = poac::util::process;
+
+        probe p;
+        p.stamps = std::move(stamps);
+
+        auto command = argv;
+        command.push_back("--version");
+        const auto version = process::run(command, { std::nullopt, true });
+        if (version.success()) {
+            p.version = version.out.substr(0, version.out.find('\n'));
+            p.is_clang = version.out.find("clang") != std::string::npos;
+        }
+
+        command = argv;
+        command.push_back("-dumpmachine");
+        if (const auto triple = process::run(command); triple.success()) {
+            p.triple = triple.out.substr(0, triple.out.find('\n'));
+        }
+
+        std::vector<process::job> jobs;
+        for (const auto level : std_levels) {
+            command = argv;
+            command.insert(command.end(), {
+                "-std=c++" + std::to_string(level), "-fsyntax-only", "-x", "c++", "/dev/null" });
+            jobs.push_back({ command });
+        }
+        std::vector<bool> supported(std_levels.size(), false);
+        process::run_all(jobs, static_cast<unsigned int>(jobs.size()), [&](std::size_t i, const process::result& r) {
+            supported[i] = r.success();
+        });
+        for (std::size_t i = 0; i < std_levels.size(); ++i) {
+            if (supported[i]) {
+                p.std_levels.push_back(std_levels[i]);
+            }
+        }
+        return p;
+    }
+
+    // `system` is a compiler command, which may have a launcher and arguments (e.g. "ccache g++").
+    const probe& get(const std::string& system) {
+        static std::mutex mtx;
+        static std::map<std::string, probe> probes;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (const auto itr = probes.find(system); itr != probes.end()) {
+            return itr->second;
+        }
+        const auto argv = utils::options::to_args(system);
+        const auto stamps = make_stamps(argv);
+        if (!stamps) { // Not found. It is reported when the compiler is run.
+            return probes.emplace(system, probe{}).first->second;
+        }
+        if (auto cached = load(system); cached && cached->stamps == *stamps) {
+            return probes.emplace(system, std::move(*cached)).first->second;
+        }
+        probe p = run_probe(argv, *stamps);
+        save(system, p);
+        return probes.emplace(system, std::move(p)).first->second;
+    }
+} // end namespace
+#endif // STROITE_CORE_TOOLCHAIN_HPP
@@ -0,0 +1,187 @@
+// Spans of a build, reported by --timings
+#ifndef STROITE_CORE_TRACE_HPP
+#define STROITE_CORE_TRACE_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "../utils/misc.hpp"
+
+
+// Nothing is recorded unless enabled, and then a span costs a clock read
+//  at each end and a push under a lock.
+//
+// Categories:
+//   phase   : resolve, configure, fingerprint, build of a package (may contain the others)
+//   compile : a translation unit (including the object cache lookup)
+//   pch, link, archive, shared : the other tools
+namespace stroite::core::trace {
+    using clock = std::chrono::steady_clock;
+
+    struct event {
+        std::string name;
+        std::string category;
+        clock::time_point start;
+        clock::time_point end;
+        std::size_t tid;
+
+        double duration() const {
+            return std::chrono::duration<double>(end - start).count();
+        }
+    };
+
+    class recorder {
+    public:
+        void enable() {
+            enabled_ = true;
+            origin = clock::now();
+        }
+        bool enabled() const {
+            return enabled_;
+        }
+        void record(event e) {
+            std::lock_guard<std::mutex> lock(mtx);
+            const auto [itr, inserted] = threads.emplace(std::this_thread::get_id(), threads.size());
+            e.tid = itr->second;
+            events_.push_back(std::move(e));
+        }
+        std::vector<event> events() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            return events_;
+        }
+        clock::time_point start() const {
+            return origin;
+        }
+
+    private:
+        std::atomic<bool> enabled_{ false };
+        clock::time_point origin;
+        mutable std::mutex mtx;
+        std::map<std::thread::id, std::size_t> threads;
+        std::vector<event> events_;
+    };
+
+    recorder& get() {
+        static recorder r;
+        return r;
+    }
+
+    class span {
+    public:
+        span(std::string name, std::string category) {
+            if (get().enabled()) {
+                e = event{ std::move(name), std::move(category), clock::now(), {}, 0 };
+            }
+        }
+        ~span() {
+            if (!e.name.empty()) {
+                e.end = clock::now();
+                get().record(std::move(e));
+            }
+        }
+        span(const span&) = delete;
+        span& operator=(const span&) = delete;
+
+    private:
+        event e;
+    };
+
+    // Spans of these categories are processes, whose sum is the work done.
+    bool is_job(const event& e) {
+        return e.category != "phase";
+    }
+
+    // The Trace Event Format, which chrome://tracing and Perfetto can open.
+    // (https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU)
+    void write_chrome_trace(const boost::filesystem::path& output) {
+        namespace fs = boost::filesystem;
+        const auto us = [](const clock::duration d) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+        };
+        boost::system::error_code error;
+        fs::create_directories(output.parent_path(), error);
+        std::ofstream ofs(output.string());
+        ofs << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto& e : get().events()) {
+            ofs << (first ? "\n" : ",\n")
+                << "{\"name\":\"" << utils::misc::escape_json(e.name) << "\""
+                << ",\"cat\":\"" << e.category << "\",\"ph\":\"X\""
+                << ",\"ts\":" << us(e.start - get().start()) << ",\"dur\":" << us(e.end - e.start)
+                << ",\"pid\":1,\"tid\":" << e.tid << "}";
+            first = false;
+        }
+        ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    // The chain of jobs, each of which started after the previous one ended, with the longest total time.
+    // Jobs on it could not have overlapped, so it is a lower bound of the build time with unlimited jobs.
+    std::vector<event> critical_path(std::vector<event> jobs) {
+        std::sort(jobs.begin(), jobs.end(), [](const auto& l, const auto& r) { return l.end < r.end; });
+        std::vector<double> longest(jobs.size());
+        std::vector<std::size_t> previous(jobs.size(), jobs.size());
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            longest[i] = jobs[i].duration();
+            for (std::size_t j = 0; j < i && jobs[j].end <= jobs[i].start; ++j) {
+                if (longest[j] + jobs[i].duration() > longest[i]) {
+                    longest[i] = longest[j] + jobs[i].duration();
+                    previous[i] = j;
+                }
+            }
+        }
+        std::vector<event> path;
+        if (jobs.empty()) {
+            return path;
+        }
+        for (auto i = static_cast<std::size_t>(std::max_element(longest.begin(), longest.end()) - longest.begin());
+             i != jobs.size(); i = previous[i])
+        {
+            path.push_back(jobs[i]);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    struct summary {
+        double wall_time = 0.0;
+        double job_time = 0.0; // Sum of all jobs
+        std::vector<event> slowest; // Translation units
+        std::vector<event> critical_path;
+
+        double parallelism() const {
+            return wall_time > 0.0 ? job_time / wall_time : 0.0;
+        }
+    };
+
+    summary summarize(const std::size_t slowest = 10) {
+        summary s;
+        std::vector<event> jobs;
+        for (const auto& e : get().events()) {
+            s.wall_time = std::max(s.wall_time, std::chrono::duration<double>(e.end - get().start()).count());
+            if (is_job(e)) {
+                s.job_time += e.duration();
+                jobs.push_back(e);
+            }
+            if (e.category == "compile") {
+                s.slowest.push_back(e);
+            }
+        }
+        std::sort(s.slowest.begin(), s.slowest.end(),
+                  [](const auto& l, const auto& r) { return l.duration() > r.duration(); });
+        if (s.slowest.size() > slowest) {
+            s.slowest.resize(slowest);
+        }
+        s.critical_path = critical_path(std::move(jobs));
+        return s;
+    }
+} // end namespace
+#endif // STROITE_CORE_TRACE_HPP
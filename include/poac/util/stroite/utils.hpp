@@ -2,7 +2,9 @@
 #define STROITE_UTILS_HPP
 
 #include "utils/configure.hpp"
+#include "utils/hash.hpp"
 #include "utils/misc.hpp"
 #include "utils/options.hpp"
+#include "utils/registry.hpp"
 
 #endif // STROITE_UTILS_HPP
\ No newline at end of file
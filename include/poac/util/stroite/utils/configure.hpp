@@ -20,7 +20,7 @@ namespace stroite::utils::configure {
         return "-std=c++";
     }
     std::string make_macro_defn(const std::string& first, const std::string& second) {
-        return "-D" + first + "=" + R"(\")" + second + R"(\")";
+        return "-D" + first + "=\"" + second + "\""; // Passed without a shell
     }
 
     // Automatic selection of compiler
@@ -0,0 +1,120 @@
+// Non-cryptographic content hash (XXH64)
+#ifndef STROITE_UTILS_HASH_HPP
+#define STROITE_UTILS_HASH_HPP
+
+#include <string>
+#include <fstream>
+#include <optional>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+
+
+namespace stroite::utils::hash {
+    namespace detail {
+        constexpr std::uint64_t prime1 = 11400714785074694791ULL;
+        constexpr std::uint64_t prime2 = 14029467366897019727ULL;
+        constexpr std::uint64_t prime3 =  1609587929392839161ULL;
+        constexpr std::uint64_t prime4 =  9650029242287828579ULL;
+        constexpr std::uint64_t prime5 =  2870177450012600261ULL;
+
+        std::uint64_t rotl(const std::uint64_t x, const int r) {
+            return (x << r) | (x >> (64 - r));
+        }
+        std::uint64_t read64(const char* p) {
+            std::uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v; // little endian is assumed
+        }
+        std::uint32_t read32(const char* p) {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        std::uint64_t round(std::uint64_t acc, const std::uint64_t input) {
+            acc += input * prime2;
+            acc = rotl(acc, 31);
+            return acc * prime1;
+        }
+        std::uint64_t merge_round(std::uint64_t acc, const std::uint64_t val) {
+            acc ^= round(0, val);
+            return acc * prime1 + prime4;
+        }
+    }
+
+    // https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    std::uint64_t xxh64(const char* data, const std::size_t len, const std::uint64_t seed = 0) {
+        using namespace detail;
+
+        const char* p = data;
+        const char* const end = data + len;
+        std::uint64_t h;
+
+        if (len >= 32) {
+            std::uint64_t v1 = seed + prime1 + prime2;
+            std::uint64_t v2 = seed + prime2;
+            std::uint64_t v3 = seed;
+            std::uint64_t v4 = seed - prime1;
+            for (const char* const limit = end - 32; p <= limit; p += 32) {
+                v1 = round(v1, read64(p));
+                v2 = round(v2, read64(p + 8));
+                v3 = round(v3, read64(p + 16));
+                v4 = round(v4, read64(p + 24));
+            }
+            h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            h = merge_round(h, v1);
+            h = merge_round(h, v2);
+            h = merge_round(h, v3);
+            h = merge_round(h, v4);
+        }
+        else {
+            h = seed + prime5;
+        }
+        h += static_cast<std::uint64_t>(len);
+
+        for (; p + 8 <= end; p += 8) {
+            h ^= round(0, read64(p));
+            h = rotl(h, 27) * prime1 + prime4;
+        }
+        if (p + 4 <= end) {
+            h ^= static_cast<std::uint64_t>(read32(p)) * prime1;
+            h = rotl(h, 23) * prime2 + prime3;
+            p += 4;
+        }
+        for (; p < end; ++p) {
+            h ^= static_cast<std::uint64_t>(static_cast<unsigned char>(*p)) * prime5;
+            h = rotl(h, 11) * prime1;
+        }
+
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    std::string to_hex(std::uint64_t h) {
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string s(16, '0');
+        for (auto itr = s.rbegin(); itr != s.rend(); ++itr, h >>= 4) {
+            *itr = digits[h & 0xf];
+        }
+        return s;
+    }
+
+    std::uint64_t string(const std::string& s) {
+        return xxh64(s.data(), s.size());
+    }
+
+    std::optional<std::uint64_t> file(const boost::filesystem::path& p) {
+        std::ifstream ifs(p.string(), std::ios::binary);
+        if (!ifs.is_open()) {
+            return std::nullopt;
+        }
+        const std::string content{ std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+        return string(content);
+    }
+} // end namespace
+#endif // STROITE_UTILS_HASH_HPP
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <sstream>
+#include <iomanip>
 
 #include <boost/algorithm/string.hpp>
 
@@ -19,5 +21,22 @@ namespace stroite::utils::misc {
         boost::split(ret, raw, is_any_of(delim), token_compress_on);
         return ret;
     }
+
+    // For a string literal of JSON
+    std::string escape_json(const std::string& s) {
+        std::ostringstream oss;
+        for (const char c : s) {
+            if (c == '"' || c == '\\') {
+                oss << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            }
+            else {
+                oss << c;
+            }
+        }
+        return oss.str();
+    }
 } // end namespace
 #endif // STROITE_UTILS_MISC_HPP
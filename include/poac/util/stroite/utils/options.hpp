@@ -7,7 +7,9 @@
 
 #include <boost/filesystem.hpp>
 
+#include "./misc.hpp"
 #include "../../command.hpp"
+#include "../../process.hpp"
 
 
 namespace stroite::utils::options {
@@ -24,25 +26,40 @@ namespace stroite::utils::options {
         std::vector<std::string> macro_defns;
         boost::filesystem::path base_dir;
         boost::filesystem::path output_root;
+        unsigned int jobs;
         bool verbose; // TODO: これ，別で渡せない？？？
+        // -fprofile-use: the merged .profdata of clang, or empty for GCC, whose .gcda is next to each object
+        bool profile_use = false;
+        std::string profile_data;
+        // Hash of the headers in the precompiled header (empty if it is not used),
+        //  which the output of -E does not expand (-fpch-preprocess)
+        std::string pch_digest;
     };
-    std::string to_string(const compile& c) {
-        command opts;
-        opts += c.version_prefix + std::to_string(c.cpp_version);
-        opts += "-c";
-        opts += accumulate(begin(c.source_files), end(c.source_files), command());
-        opts += accumulate(begin(c.include_search_path), end(c.include_search_path), command(),
-                [](command acc, auto s) { return acc + ("-I" + s); });
-        opts += accumulate(begin(c.other_args), end(c.other_args), command());
-        opts += accumulate(begin(c.macro_defns), end(c.macro_defns), command());
-        opts += "-o";
-        for (const auto& s : c.source_files) {
-            auto obj_path = c.output_root / fs::relative(s);
-            obj_path.replace_extension("o");
-            fs::create_directories(obj_path.parent_path());
-            opts += obj_path.string();
+    // `system` may have arguments (e.g. CXX="ccache g++").
+    std::vector<std::string> to_args(const std::string& system) {
+        std::vector<std::string> args;
+        for (auto& a : misc::split(system, " \t")) {
+            if (!a.empty()) {
+                args.push_back(std::move(a));
+            }
         }
-        return opts.data();
+        return args;
+    }
+
+    // Flags shared by every translation unit.
+    // (-c, the source file and -o are added per translation unit.)
+    std::vector<std::string> to_args(const compile& c) {
+        std::vector<std::string> args;
+        args.push_back(c.version_prefix + std::to_string(c.cpp_version));
+        for (const auto& i : c.include_search_path) {
+            args.push_back("-I" + i);
+        }
+        args.insert(args.end(), c.other_args.begin(), c.other_args.end());
+        args.insert(args.end(), c.macro_defns.begin(), c.macro_defns.end());
+        return args;
+    }
+    std::string to_string(const compile& c) {
+        return poac::util::process::to_string(to_args(c));
     }
 
     struct link {
@@ -56,17 +73,22 @@ namespace stroite::utils::options {
         std::vector<std::string> other_args;
         bool verbose;
     };
+    std::vector<std::string> to_args(const link& l) {
+        std::vector<std::string> args = l.obj_files_path;
+        for (const auto& lsp : l.library_search_path) {
+            args.push_back("-L" + lsp);
+        }
+        for (const auto& sll : l.static_link_libs) {
+            args.push_back("-l" + sll);
+        }
+        args.insert(args.end(), l.library_path.begin(), l.library_path.end());
+        args.insert(args.end(), l.other_args.begin(), l.other_args.end());
+        args.push_back("-o");
+        args.push_back((l.output_root / l.project_name).string());
+        return args;
+    }
     std::string to_string(const link& l) {
-        command opts;
-        opts += accumulate(begin(l.obj_files_path), end(l.obj_files_path), command());
-        opts += accumulate(begin(l.library_search_path), end(l.library_search_path), command(),
-                           [](command acc, auto s) { return acc + ("-L" + s); });
-        opts += accumulate(begin(l.static_link_libs), end(l.static_link_libs), command(),
-                           [](command acc, auto s) { return acc + ("-l" + s); });
-        opts += accumulate(begin(l.library_path), end(l.library_path), command());
-        opts += accumulate(begin(l.other_args), end(l.other_args), command());
-        opts += "-o " + (l.output_root / l.project_name).string();
-        return opts.data();
+        return poac::util::process::to_string(to_args(l));
     }
 
     struct static_lib {
@@ -82,26 +104,37 @@ namespace stroite::utils::options {
         return opts.data();
     }
 
+#ifdef __APPLE__
+    const std::string dynamic_lib_extension = ".dylib";
+#else
+    const std::string dynamic_lib_extension = ".so";
+#endif
+
     struct dynamic_lib {
         std::string system;
         std::string project_name;
         boost::filesystem::path output_root;
         std::vector<std::string> obj_files_path;
+        std::vector<std::string> other_args;
         bool verbose;
     };
-    std::string to_string(const dynamic_lib& d) {
-        command opts;
+    // Objects must be compiled with -fPIC.
+    // The install name (soname) is the file name, so that dependents load it from their search path.
+    std::vector<std::string> to_args(const dynamic_lib& d) {
+        const std::string filename = d.project_name + dynamic_lib_extension;
 #ifdef __APPLE__
-        opts += "-dynamiclib";
-        const std::string extension = ".dylib";
+        std::vector<std::string> args{ "-dynamiclib", "-Wl,-install_name,@rpath/" + filename };
 #else
-        opts += "-shared -fPIC";
-        const std::string extension = ".so";
+        std::vector<std::string> args{ "-shared", "-Wl,-soname," + filename };
 #endif
-        opts += accumulate(begin(d.obj_files_path), end(d.obj_files_path), command());
-        opts += "-o";
-        opts += (d.output_root / d.project_name).string() + extension;
-        return opts.data();
+        args.insert(args.end(), d.obj_files_path.begin(), d.obj_files_path.end());
+        args.insert(args.end(), d.other_args.begin(), d.other_args.end());
+        args.push_back("-o");
+        args.push_back((d.output_root / filename).string());
+        return args;
+    }
+    std::string to_string(const dynamic_lib& d) {
+        return poac::util::process::to_string(to_args(d));
     }
 } // end namespace
 #endif // STROITE_UTILS_OPTIONS_HPP
@@ -0,0 +1,30 @@
+// One instance per file in the process
+#ifndef STROITE_UTILS_REGISTRY_HPP
+#define STROITE_UTILS_REGISTRY_HPP
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <boost/filesystem.hpp>
+
+
+namespace stroite::utils::registry {
+    // Builders of all packages in a project write the same files (e.g. the build state),
+    //  so they share the object which owns each file instead of opening it again.
+    // `T` is constructed from the path on first use, and lives until the process exits.
+    template <typename T>
+    T& open(const boost::filesystem::path& p) {
+        static std::mutex mtx;
+        static std::map<std::string, std::unique_ptr<T>> instances;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        auto& instance = instances[p.string()];
+        if (!instance) {
+            instance = std::make_unique<T>(p);
+        }
+        return *instance;
+    }
+} // end namespace
+#endif // STROITE_UTILS_REGISTRY_HPP
@@ -0,0 +1,180 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <poac/core/pubgrub.hpp>
+#include <poac/core/exception.hpp>
+
+#include <string>
+#include <map>
+#include <set>
+
+using Registry = std::map<std::string, std::map<std::string, poac::core::pubgrub::Dependencies>>;
+
+// Records which packages and versions are queried.
+struct Queried {
+    std::set<std::string> versions;
+    std::set<std::string> dependencies;
+};
+
+poac::core::pubgrub::Provider
+make_provider(const Registry& registry, Queried& queried) {
+    return {
+        [&](const std::string& name) -> std::optional<std::vector<std::string>> {
+            queried.versions.insert(name);
+            const auto itr = registry.find(name);
+            if (itr == registry.end()) {
+                return std::nullopt;
+            }
+            std::vector<std::string> versions;
+            for (const auto& [version, deps] : itr->second) {
+                versions.push_back(version);
+            }
+            return versions;
+        },
+        [&](const std::string& name, const std::string& version) {
+            queried.dependencies.insert(name + " " + version);
+            return registry.at(name).at(version);
+        }
+    };
+}
+
+std::string solve_error(const Registry& registry, const poac::core::pubgrub::Dependencies& deps) {
+    Queried queried;
+    try {
+        poac::core::pubgrub::solve(make_provider(registry, queried), "root", deps);
+    }
+    catch (const poac::core::exception::error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+
+BOOST_AUTO_TEST_CASE( poac_core_pubgrub_newest )
+{
+    using namespace poac::core::pubgrub;
+
+    Registry registry;
+    registry["A"]["1.0.0"] = {};
+    registry["A"]["1.10.0"] = { { "B", ">=1.0.0" } };
+    registry["A"]["1.2.0"] = { { "C", "1.0.0" } };
+    registry["B"]["1.0.0"] = {};
+    registry["B"]["1.1.0"] = {};
+    registry["C"]["1.0.0"] = {};
+
+    Queried queried;
+    const auto result = solve(make_provider(registry, queried), "root", { { "A", ">=1.0.0" } });
+    BOOST_TEST( result.size() == 2 );
+    BOOST_TEST( result.at("A").version == "1.10.0" );
+    BOOST_TEST( result.at("B").version == "1.1.0" );
+    BOOST_TEST( result.at("A").dependencies == Dependencies({ { "B", ">=1.0.0" } }) );
+
+    // Only the selected versions are queried.
+    BOOST_TEST( queried.versions == std::set<std::string>({ "A", "B" }) );
+    BOOST_TEST( queried.dependencies == std::set<std::string>({ "A 1.10.0", "B 1.1.0" }) );
+}
+
+// https://github.com/dart-lang/pub/blob/master/doc/solver.md#performing-conflict-resolution
+BOOST_AUTO_TEST_CASE( poac_core_pubgrub_conflict_resolution )
+{
+    using namespace poac::core::pubgrub;
+
+    Registry registry;
+    registry["foo"]["1.0.0"] = {};
+    registry["foo"]["2.0.0"] = { { "bar", "1.0.0" } };
+    registry["bar"]["1.0.0"] = { { "foo", "1.0.0" } };
+
+    Queried queried;
+    const auto result = solve(make_provider(registry, queried), "root", { { "foo", ">=1.0.0" } });
+    BOOST_TEST( result.size() == 1 );
+    BOOST_TEST( result.at("foo").version == "1.0.0" );
+}
+
+// Both sides of a diamond have to go back to older versions.
+BOOST_AUTO_TEST_CASE( poac_core_pubgrub_backtracking )
+{
+    using namespace poac::core::pubgrub;
+
+    Registry registry;
+    registry["a"]["1.0.0"] = { { "c", "1.0.0" } };
+    registry["a"]["2.0.0"] = { { "c", "2.0.0" } };
+    registry["b"]["1.0.0"] = { { "c", "1.0.0" } };
+    registry["b"]["2.0.0"] = { { "c", "3.0.0" } };
+    registry["c"]["1.0.0"] = {};
+    registry["c"]["2.0.0"] = {};
+    registry["c"]["3.0.0"] = {};
+
+    Queried queried;
+    const auto result = solve(make_provider(registry, queried), "root", { { "a", ">=1.0.0" }, { "b", ">=1.0.0" } });
+    BOOST_TEST( result.at("c").version == "1.0.0" );
+    BOOST_TEST( result.at("a").version == "1.0.0" );
+    BOOST_TEST( result.at("b").version == "1.0.0" );
+}
+
+BOOST_AUTO_TEST_CASE( poac_core_pubgrub_latest )
+{
+    using namespace poac::core::pubgrub;
+
+    Registry registry;
+    registry["A"]["0.9.0"] = {};
+    registry["A"]["1.0.0"] = {};
+
+    Queried queried;
+    const auto result = solve(make_provider(registry, queried), "root", { { "A", "latest" } });
+    BOOST_TEST( result.at("A").version == "1.0.0" );
+}
+
+// https://github.com/dart-lang/pub/blob/master/doc/solver.md#linear-error-reporting
+BOOST_AUTO_TEST_CASE( poac_core_pubgrub_explanation )
+{
+    using namespace poac::core::pubgrub;
+
+    Registry registry;
+    registry["foo"]["1.0.0"] = { { "bar", ">=2.0.0 and <3.0.0" } };
+    registry["bar"]["2.0.0"] = { { "baz", ">=3.0.0 and <4.0.0" } };
+    registry["baz"]["1.0.0"] = {};
+    registry["baz"]["3.0.0"] = {};
+
+    const std::string error = solve_error(registry, { { "foo", ">=1.0.0 and <2.0.0" }, { "baz", ">=1.0.0 and <2.0.0" } });
+    BOOST_TEST( error.find("foo depends on bar >=2.0.0 and <3.0.0") != std::string::npos );
+    BOOST_TEST( error.find("bar depends on baz >=3.0.0 and <4.0.0") != std::string::npos );
+    BOOST_TEST( error.find("root depends on baz >=1.0.0 and <2.0.0") != std::string::npos );
+    BOOST_TEST( error.find("version solving failed.") != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( poac_core_pubgrub_not_found )
+{
+    using namespace poac::core::pubgrub;
+
+    Registry registry;
+    registry["A"]["1.0.0"] = { { "B", ">=2.0.0" } };
+    registry["B"]["1.0.0"] = {};
+
+    const std::string error = solve_error(registry, { { "A", "1.0.0" } });
+    BOOST_TEST( error.find("A depends on B >=2.0.0 which doesn't match any versions") != std::string::npos );
+    BOOST_TEST( error.find("version solving failed.") != std::string::npos );
+
+    BOOST_TEST( solve_error(registry, { { "C", "1.0.0" } })
+                == "Because root depends on C 1.0.0 which doesn't match any versions, version solving failed." );
+}
+
+// https://github.com/dart-lang/pub/blob/master/doc/solver.md#branching-error-reporting
+BOOST_AUTO_TEST_CASE( poac_core_pubgrub_branching_explanation )
+{
+    using namespace poac::core::pubgrub;
+
+    Registry registry;
+    registry["foo"]["1.0.0"] = { { "a", ">=1.0.0 and <2.0.0" }, { "b", ">=1.0.0 and <2.0.0" } };
+    registry["foo"]["1.1.0"] = { { "x", ">=1.0.0 and <2.0.0" }, { "y", ">=1.0.0 and <2.0.0" } };
+    registry["a"]["1.0.0"] = { { "b", ">=2.0.0 and <3.0.0" } };
+    registry["b"]["1.0.0"] = {};
+    registry["b"]["2.0.0"] = {};
+    registry["x"]["1.0.0"] = { { "y", ">=2.0.0 and <3.0.0" } };
+    registry["y"]["1.0.0"] = {};
+    registry["y"]["2.0.0"] = {};
+
+    const std::string error = solve_error(registry, { { "foo", ">=1.0.0 and <2.0.0" } });
+    // The conclusion of one branch is referred to by its number.
+    BOOST_TEST( error.find("(1) ") != std::string::npos );
+    BOOST_TEST( error.find("foo 1.1.0 is required (1), version solving failed.") != std::string::npos );
+}
@@ -3,32 +3,137 @@
 #include <boost/test/unit_test.hpp>
 #include <poac/core/resolver.hpp>
 
+#include <string>
+#include <map>
 
+using Registry = std::map<std::string, std::map<std::string, poac::core::pubgrub::Dependencies>>;
+
+poac::core::pubgrub::Provider
+make_provider(const Registry& registry) {
+    return {
+        [&](const std::string& name) -> std::optional<std::vector<std::string>> {
+            const auto itr = registry.find(name);
+            if (itr == registry.end()) {
+                return std::nullopt;
+            }
+            std::vector<std::string> versions;
+            for (const auto& [version, deps] : itr->second) {
+                versions.push_back(version);
+            }
+            return versions;
+        },
+        [&](const std::string& name, const std::string& version) {
+            return registry.at(name).at(version);
+        }
+    };
+}
+
+
+// Resolved resolve(const Deps& deps, const std::string& root, const pubgrub::Provider& provider)
 BOOST_AUTO_TEST_CASE( poac_core_resolver_test1 )
 {
     using namespace poac::core::resolver;
 
-    Activated test{};
-    test.push_back({ {"D"}, {"1.0.0"}, {""}, {} });
-    test.push_back({ {"D"}, {"1.1.0"}, {""}, {} });
-    test.push_back({ {"E"}, {"1.0.0"}, {""}, {} });
-    test.push_back({ {"A"}, {"1.0.0"}, {""}, {} });
-    test.push_back({ {"B"}, {"1.0.0"}, {""}, {{
-            { {"D"}, {"1.0.0"}, {""}, {} },
-            { {"D"}, {"1.1.0"}, {""}, {} },
-            { {"E"}, {"1.0.0"}, {""}, {} }
-    }} });
-    test.push_back({ {"C"}, {"1.0.0"}, {""}, {{
-            { {"D"}, {"1.1.0"}, {""}, {} }
-    }} });
+    Registry registry;
+    registry["D"]["1.0.0"] = {};
+    registry["D"]["1.1.0"] = {};
+    registry["E"]["1.0.0"] = {};
+    registry["A"]["1.0.0"] = {};
+    registry["B"]["1.0.0"] = { { "D", ">=1.0.0 and <2.0.0" }, { "E", "1.0.0" } };
+    registry["C"]["1.0.0"] = { { "D", "1.1.0" } };
+
+    Deps deps;
+    deps.push_back({ {"A"}, {">=1.0.0"}, {"poac"} });
+    deps.push_back({ {"B"}, {">=1.0.0"}, {"poac"} });
+    deps.push_back({ {"C"}, {">=1.0.0"}, {"poac"} });
+
+    Backtracked backtracked;
+    backtracked["A"] = { {"1.0.0"}, {"poac"} };
+    backtracked["B"] = { {"1.0.0"}, {"poac"} };
+    backtracked["C"] = { {"1.0.0"}, {"poac"} };
+    backtracked["D"] = { {"1.1.0"}, {"poac"} };
+    backtracked["E"] = { {"1.0.0"}, {"poac"} };
+
+    const Resolved result = resolve(deps, "root", make_provider(registry));
+    BOOST_TEST( result.backtracked == backtracked );
+    BOOST_TEST( result.activated.size() == 5u );
+}
+
+// A package with a long release history
+BOOST_AUTO_TEST_CASE( poac_core_resolver_test2 )
+{
+    using namespace poac::core::resolver;
+
+    Registry registry;
+    for (int i = 0; i < 40; ++i) {
+        registry["D"]["1.0." + std::to_string(i)] = {};
+    }
+    registry["A"]["1.0.0"] = { { "D", ">=1.0.7 and <1.0.9" } };
+    registry["B"]["1.0.0"] = { { "D", ">=1.0.8 and <1.0.10" } };
+
+    Deps deps;
+    deps.push_back({ {"A"}, {"1.0.0"}, {"poac"} });
+    deps.push_back({ {"B"}, {"1.0.0"}, {"poac"} });
+
+    Backtracked backtracked;
+    backtracked["A"] = { {"1.0.0"}, {"poac"} };
+    backtracked["B"] = { {"1.0.0"}, {"poac"} };
+    backtracked["D"] = { {"1.0.8"}, {"poac"} };
+
+    const Resolved result = resolve(deps, "root", make_provider(registry));
+    BOOST_TEST( result.backtracked == backtracked );
+}
+
+// The newest versions, and only the packages which they depend on
+BOOST_AUTO_TEST_CASE( poac_core_resolver_test3 )
+{
+    using namespace poac::core::resolver;
+
+    Registry registry;
+    registry["C"]["1.0.0"] = {};
+    registry["C"]["2.0.0"] = {};
+    registry["D"]["1.0.0"] = {};
+    registry["B"]["0.9.0"] = { { "D", "1.0.0" } };
+    registry["B"]["1.10.0"] = {};
+    registry["B"]["1.2.0"] = { { "C", ">=1.0.0" } };
+    registry["A"]["1.0.0"] = { { "B", ">=0.9.0" }, { "C", ">=1.0.0" } };
+
+    Deps deps;
+    deps.push_back({ {"A"}, {"1.0.0"}, {"poac"} });
+    // Packages from other sources are not resolved.
+    deps.push_back({ {"E"}, {"v1.0.0"}, {"github"} });
 
     Backtracked backtracked;
-    backtracked["A"] = { {"1.0.0"}, {""} };
-    backtracked["B"] = { {"1.0.0"}, {""} };
-    backtracked["C"] = { {"1.0.0"}, {""} };
-    backtracked["D"] = { {"1.1.0"}, {""} };
-    backtracked["E"] = { {"1.0.0"}, {""} };
+    backtracked["A"] = { {"1.0.0"}, {"poac"} };
+    backtracked["B"] = { {"1.10.0"}, {"poac"} };
+    backtracked["C"] = { {"2.0.0"}, {"poac"} };
+    backtracked["E"] = { {"v1.0.0"}, {"github"} };
 
-    const Resolved result = backtrack_loop(test);
+    // D is required only by an older version of B.
+    const Resolved result = resolve(deps, "root", make_provider(registry));
     BOOST_TEST( result.backtracked == backtracked );
+    // Dependencies come before their dependents.
+    BOOST_TEST( result.activated.size() == 4u );
+    BOOST_TEST( result.activated[2].name == "A" );
+    BOOST_TEST( result.activated[2].deps.size() == 2u );
+}
+
+// The root is named in the explanation of a failure.
+BOOST_AUTO_TEST_CASE( poac_core_resolver_test4 )
+{
+    using namespace poac::core::resolver;
+
+    Registry registry;
+    registry["A"]["1.0.0"] = {};
+
+    Deps deps;
+    deps.push_back({ {"A"}, {">=2.0.0"}, {"poac"} });
+
+    try {
+        resolve(deps, "my-project", make_provider(registry));
+        BOOST_TEST( false );
+    }
+    catch (const poac::core::exception::error& e) {
+        BOOST_TEST( std::string(e.what()).find("my-project depends on A >=2.0.0") != std::string::npos );
+    }
 }
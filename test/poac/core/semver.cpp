@@ -18,6 +18,8 @@ BOOST_AUTO_TEST_CASE( poac_core_semver_eq_test )
 BOOST_AUTO_TEST_CASE( poac_core_semver_lt_test )
 {
     using poac::core::semver::Version;
+    BOOST_TEST( !(Version("1.2.0") < "1.0.5") );
+    BOOST_TEST( !(Version("2.0.0") < "1.9.9") );
     BOOST_TEST( Version("1.2.3") < "1.2.4" );
     BOOST_TEST( Version("1.2.3") < "1.3.3" );
     BOOST_TEST( Version("1.2.3") < "2.2.3" );
@@ -38,6 +40,7 @@ BOOST_AUTO_TEST_CASE( poac_core_semver_lt_test )
 BOOST_AUTO_TEST_CASE( poac_core_semver_lte_test )
 {
     using poac::core::semver::Version;
+    BOOST_TEST( !(Version("1.2.0") <= "1.0.5") );
     BOOST_TEST( Version("1.2.3") <= "1.2.3" );
     BOOST_TEST( Version("1.2.3-alpha") <= "1.2.3-alpha" );
     BOOST_TEST( Version("1.2.3+2013") <= "1.2.3+2014" );
@@ -64,6 +67,8 @@ BOOST_AUTO_TEST_CASE( poac_core_semver_lte_test )
 BOOST_AUTO_TEST_CASE( poac_core_semver_gt_test )
 {
     using poac::core::semver::Version;
+    BOOST_TEST( !(Version("1.2.0") > "2.0.0") );
+    BOOST_TEST( !(Version("1.0.5") > "1.2.0") );
     BOOST_TEST( Version("1.2.4") > "1.2.3" );
     BOOST_TEST( Version("1.3.3") > "1.2.3" );
     BOOST_TEST( Version("2.2.3") > "1.2.3" );
@@ -84,6 +89,8 @@ BOOST_AUTO_TEST_CASE( poac_core_semver_gt_test )
 BOOST_AUTO_TEST_CASE( poac_core_semver_gte_test )
 {
     using poac::core::semver::Version;
+    BOOST_TEST( !(Version("1.0.0") >= "2.0.0") );
+    BOOST_TEST( !(Version("1.9.9") >= "2.0.0") );
     BOOST_TEST( Version("1.2.3") >= "1.2.3" );
     BOOST_TEST( Version("1.2.3-alpha") >= "1.2.3-alpha" );
     BOOST_TEST( Version("1.2.3+2013") >= "1.2.3+2014" );
@@ -117,6 +124,8 @@ BOOST_AUTO_TEST_CASE( poac_core_semver_satisfies_test )
     BOOST_TEST( interval.satisfies("1.69.0") );
     BOOST_TEST( interval.satisfies("1.69.9") );
     BOOST_TEST( !interval.satisfies("1.70.0") );
+    BOOST_TEST( !interval.satisfies("1.9.0") );
+    BOOST_TEST( !interval.satisfies("2.66.0") );
 }
 
 BOOST_AUTO_TEST_CASE( poac_core_semver_satisfies_test2 )
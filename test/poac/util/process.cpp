@@ -0,0 +1,110 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <poac/util/process.hpp>
+
+
+// result run(const std::vector<std::string>& argv, const options& opts = {})
+BOOST_AUTO_TEST_CASE( poac_util_process_run_test1 )
+{
+    using namespace poac::util;
+
+    const auto result = process::run({ "echo", "hello", "world" });
+    BOOST_TEST( result.success() );
+    BOOST_TEST( result.out == "hello world\n" );
+    BOOST_TEST( result.err.empty() );
+}
+
+// Arguments are not interpreted by a shell.
+BOOST_AUTO_TEST_CASE( poac_util_process_run_test2 )
+{
+    using namespace poac::util;
+
+    const auto result = process::run({ "echo", "\"$HOME\" && ;" });
+    BOOST_TEST( result.out == "\"$HOME\" && ;\n" );
+}
+
+// Exit codes and stderr
+BOOST_AUTO_TEST_CASE( poac_util_process_run_test3 )
+{
+    using namespace poac::util;
+
+    const auto result = process::run({ "sh", "-c", "echo out; echo err 1>&2; exit 3" });
+    BOOST_TEST( !result.success() );
+    BOOST_TEST( result.exit_code == 3 );
+    BOOST_TEST( result.out == "out\n" );
+    BOOST_TEST( result.err == "err\n" );
+
+    const auto merged = process::run({ "sh", "-c", "echo out; echo err 1>&2" }, { std::nullopt, true });
+    BOOST_TEST( merged.out == "out\nerr\n" );
+    BOOST_TEST( merged.err.empty() );
+}
+
+// Working directory
+BOOST_AUTO_TEST_CASE( poac_util_process_run_test4 )
+{
+    using namespace poac::util;
+
+    const auto result = process::run({ "pwd" }, { boost::filesystem::path("/"), false });
+    BOOST_TEST( result.out == "/\n" );
+
+    const auto missing = process::run({ "pwd" }, { boost::filesystem::path("/poac-no-such-dir"), false });
+    BOOST_TEST( missing.exit_code == 127 );
+    BOOST_TEST( missing.err == "cannot change the working directory\n" );
+}
+
+// Output larger than a pipe buffer
+BOOST_AUTO_TEST_CASE( poac_util_process_run_test5 )
+{
+    using namespace poac::util;
+
+    const auto result = process::run({ "head", "-c", "1000000", "/dev/zero" });
+    BOOST_TEST( result.success() );
+    BOOST_TEST( result.out.size() == 1000000u );
+}
+
+// A command which does not exist
+BOOST_AUTO_TEST_CASE( poac_util_process_run_test6 )
+{
+    using namespace poac::util;
+
+    const auto result = process::run({ "poac-no-such-command" });
+    BOOST_TEST( result.exit_code == 127 );
+    BOOST_TEST( result.err == "poac-no-such-command: command not found\n" );
+    // Reported in out, which is the only output printed if stderr is merged.
+    const auto merged = process::run({ "poac-no-such-command" }, { std::nullopt, true });
+    BOOST_TEST( merged.exit_code == 127 );
+    BOOST_TEST( merged.out == "poac-no-such-command: command not found\n" );
+    BOOST_TEST( merged.err.empty() );
+    BOOST_TEST( !process::find_executable("poac-no-such-command") );
+    BOOST_TEST( process::find_executable("sh").has_value() );
+}
+
+// void run_all(const std::vector<job>& jobs, const unsigned int limit, const std::function<...>& on_complete)
+BOOST_AUTO_TEST_CASE( poac_util_process_run_all_test1 )
+{
+    using namespace poac::util;
+
+    std::vector<process::job> jobs;
+    for (int i = 0; i < 8; ++i) {
+        jobs.push_back({ { "sh", "-c", "sleep 0.2; echo " + std::to_string(i) + "; exit " + std::to_string(i % 2) } });
+    }
+    jobs.push_back({ { "poac-no-such-command" } });
+
+    std::vector<int> exit_codes(jobs.size(), -1);
+    std::vector<std::string> outputs(jobs.size());
+    const auto start = std::chrono::steady_clock::now();
+    process::run_all(jobs, 4, [&](std::size_t i, const process::result& r) {
+        exit_codes[i] = r.exit_code;
+        outputs[i] = r.out;
+    });
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (int i = 0; i < 8; ++i) {
+        BOOST_TEST( exit_codes[i] == i % 2 );
+        BOOST_TEST( outputs[i] == std::to_string(i) + "\n" );
+    }
+    BOOST_TEST( exit_codes[8] == 127 );
+    // 8 jobs of 0.2s on 4 slots
+    BOOST_TEST( elapsed.count() < 1.2 );
+}